@@ -141,7 +141,7 @@ AC_MSG_CHECKING([for thread local storage type qualifier])
 # These headers and types are needed by projects/simulator2
 AC_CHECK_HEADERS([asm/ldt.h elf.h linux/types.h linux/dirent.h linux/unistd.h])
 AC_CHECK_HEADERS([sys/types.h sys/mman.h sys/stat.h sys/uio.h sys/wait.h sys/utsname.h sys/ioctl.h sys/sysinfo.h sys/socket.h])
-AC_CHECK_HEADERS([termios.h grp.h syscall.h sys/personality.h])
+AC_CHECK_HEADERS([termios.h grp.h syscall.h sys/personality.h linux/perf_event.h])
 AC_CHECK_FUNCS(pipe2)
 AC_CHECK_TYPE(user_desc,
               AC_DEFINE(HAVE_USER_DESC, [], [Defined if the user_desc type is declared in <asm/ldt.h>]),
@@ -34,3 +34,32 @@ AM_CONDITIONAL(WITH_GOMP_OPENMP_LIB,test ! "$with_gomp_omp_runtime_library" = no
 
 ]
 )
+
+AC_DEFUN([ROSE_WITH_NATIVE_XOMP_RUNTIME],
+[
+# Begin macro ROSE_WITH_NATIVE_XOMP_RUNTIME.
+# Build libxomp.a on ROSE's own pthread-based runtime instead of GOMP or Omni.
+
+AC_MSG_CHECKING(for the native XOMP runtime)
+AC_ARG_ENABLE(xomp-native-runtime,
+[  --enable-xomp-native-runtime	Build libxomp.a with its native work-stealing runtime instead of GOMP or Omni],
+,
+if test ! "$enable_xomp_native_runtime" ; then
+   enable_xomp_native_runtime=no
+fi
+)
+
+AC_MSG_NOTICE([in ROSE SUPPORT MACRO: enable_xomp_native_runtime = "$enable_xomp_native_runtime"])
+
+if test "$enable_xomp_native_runtime" = no; then
+   AC_MSG_NOTICE([skipping use of the native XOMP runtime.])
+else
+   AC_MSG_NOTICE([libxomp.a uses the native XOMP runtime.])
+   AC_DEFINE([USE_ROSE_NATIVE_XOMP_RUNTIME],1,[Controls use of the native XOMP runtime (work-stealing tasks, self-scheduled loops) instead of GOMP or Omni.])
+fi
+
+# End macro ROSE_WITH_NATIVE_XOMP_RUNTIME.
+AM_CONDITIONAL(WITH_NATIVE_XOMP_RUNTIME,test ! "$enable_xomp_native_runtime" = no)
+
+]
+)
@@ -1101,6 +1101,9 @@ ROSE_SUPPORT_OMNI_OPENMP
 # AM_CONDITIONAL is already included into the macro
 ROSE_WITH_GOMP_OPENMP_LIBRARY
 
+# call supporting macro for the native XOMP runtime, which takes precedence over GOMP and Omni
+ROSE_WITH_NATIVE_XOMP_RUNTIME
+
 # Call supporting macro for GCC OpenMP
 ROSE_SUPPORT_GCC_OMP
 
@@ -54,6 +54,8 @@ namespace AutoParallelization
   extern bool b_unique_indirect_index; // assume all arrays used as indirect indices has unique elements(no overlapping)
   extern bool enable_distance; // print out absolute dependence distance for a dependence relation preventing from parallelization
   extern bool dump_annot_file; // print out annotation file's content
+  extern bool enable_simd; // add simd to parallel innermost loops with unit-stride accesses, and simd safelen() to some unparallelizable ones
+  extern bool enable_collapse; // add collapse(n) to perfectly nested, rectangular loops which are all parallelizable
   extern std::vector<std::string> annot_filenames;
 
   extern bool keep_c99_loop_init; // avoid normalize C99 style loop init statement: for (int i=0; ...)
@@ -163,16 +165,30 @@ namespace AutoParallelization
 
   // Eliminate irrelevant dependencies for a loop node 'sg_node'
   // Save the remaining dependencies which prevent parallelization
+  // Dependencies carried by any of the outermost carry_levels loops are kept, which is used to check collapsing loop nests
   void DependenceElimination(SgNode* sg_node, LoopTreeDepGraph* depgraph, std::vector<DepInfo>&remain, OmpSupport::OmpAttribute* attribute, 
-       std::map<SgNode*, bool> & indirectTable, ArrayInterface* array_interface=0, ArrayAnnotation* annot=0);
+       std::map<SgNode*, bool> & indirectTable, ArrayInterface* array_interface=0, ArrayAnnotation* annot=0, int carry_levels=1);
 
 #if 0 // refactored into the OmpSupport namespace
   //Generate and insert OpenMP pragmas according to OmpAttribute
   void generatedOpenMPPragmas(SgNode* node);
 #endif
   //Parallelize an input loop at its outermost loop level, return true if successful
+  //With enable_simd, an unparallelizable innermost loop may still get a simd directive, in which case true is returned as well
   bool ParallelizeOutermostLoop(SgNode* loop, ArrayInterface* array_interface, ArrayAnnotation* annot);
 
+  //! Count the loops of a perfectly nested, rectangular loop nest starting from a canonical loop, including the loop itself
+  int countPerfectlyNestedLoops(SgForStatement* loop);
+
+  //! Check if a canonical loop is innermost, has a unit step, and all its array accesses are unit-stride or invariant with respect to its loop index
+  bool isSimdCandidate(SgForStatement* loop);
+
+  //! Return the safe vector length of a loop given its remaining dependencies, which must all have constant distances. Return 0 if there is none
+  int computeSimdSafeLength(const std::vector<DepInfo>& remain);
+
+  //! Check if a loop is one of the inner loops folded into an enclosing loop's collapse clause
+  bool isCollapsedIntoEnclosingLoop(SgForStatement* loop);
+
   //! Generate patch files for the introduced OpenMP pragmas (represented as OmpAttribute)
   void generatePatchFile(SgSourceFile* sfile);
 
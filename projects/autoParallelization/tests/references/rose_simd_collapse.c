@@ -0,0 +1,55 @@
+/* Loops for simd and collapse annotations:
+ * -rose:autopar:enable_simd -rose:autopar:enable_collapse
+ * */
+#define N 256
+#include <omp.h> 
+double a[256][256];
+double b[256][256];
+double c[256][256];
+float x[256] __attribute__((aligned(32)));
+float y[256] __attribute__((aligned(32)));
+float z[256];
+
+void foo()
+{
+  int i;
+  int j;
+// collapse(2) parallel for simd
+  
+#pragma omp parallel for simd private (i,j) collapse (2)
+  for (i = 0; i <= 255; i += 1) {
+    for (j = 0; j <= 255; j += 1) {
+      a[i][j] = b[i][j] + c[i][j];
+    }
+  }
+// parallel for simd aligned(x,y:32)
+  
+#pragma omp parallel for simd private (i) aligned (x,y:32)
+  for (i = 0; i <= 255; i += 1) {
+    x[i] = x[i] * 2.0f + y[i];
+  }
+// not rectangular: parallel for on the outer loop, simd on the inner loop
+  
+#pragma omp parallel for private (i,j)
+  for (i = 0; i <= 255; i += 1) {
+    
+#pragma omp simd private (j)
+    for (j = 0; j <= i; j += 1) {
+      a[i][j] = b[i][j];
+    }
+  }
+// parallel for collapse(2), no simd since the inner loop walks columns
+  
+#pragma omp parallel for private (j,i) collapse (2)
+  for (j = 0; j <= 255; j += 1) {
+    for (i = 0; i <= 255; i += 1) {
+      a[i][j] = b[i][j] * 2.0;
+    }
+  }
+// dependence distance 4: simd safelen(4)
+  
+#pragma omp simd private (i) safelen (4) aligned (y:32)
+  for (i = 4; i <= 255; i += 1) {
+    z[i] = z[i - 4] + y[i];
+  }
+}
@@ -0,0 +1,35 @@
+/* Loops for simd and collapse annotations:
+ * -rose:autopar:enable_simd -rose:autopar:enable_collapse
+ * */
+#define N 256
+double a[N][N], b[N][N], c[N][N];
+float x[N] __attribute__((aligned(32)));
+float y[N] __attribute__((aligned(32)));
+float z[N];
+
+void foo()
+{
+  int i, j;
+  // collapse(2) parallel for simd
+  for (i = 0; i < N; i++)
+    for (j = 0; j < N; j++)
+      a[i][j] = b[i][j] + c[i][j];
+
+  // parallel for simd aligned(x,y:32)
+  for (i = 0; i < N; i++)
+    x[i] = x[i] * 2.0f + y[i];
+
+  // not rectangular: parallel for on the outer loop, simd on the inner loop
+  for (i = 0; i < N; i++)
+    for (j = 0; j <= i; j++)
+      a[i][j] = b[i][j];
+
+  // parallel for collapse(2), no simd since the inner loop walks columns
+  for (j = 0; j < N; j++)
+    for (i = 0; i < N; i++)
+      a[i][j] = b[i][j] * 2.0;
+
+  // dependence distance 4: simd safelen(4)
+  for (i = 4; i < N; i++)
+    z[i] = z[i - 4] + y[i];
+}
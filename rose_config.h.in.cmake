@@ -653,6 +653,9 @@
 //AS Don't know what to do with this
 #undef USE_ROSE_OMNI_OPENMP_SUPPORT
 
+/* Controls use of the native XOMP runtime (work-stealing tasks, self-scheduled loops) instead of GOMP or Omni. */
+#cmakedefine USE_ROSE_NATIVE_XOMP_RUNTIME
+
 /* Always enable Fortran support whenever Java and gfortran are present */
 //AS don't know what to do with this
 #undef USE_ROSE_OPEN_FORTRAN_PARSER_SUPPORT
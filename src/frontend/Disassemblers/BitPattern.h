@@ -117,12 +117,21 @@ public:
     }
 
     /** Returns the mask for the specified word. The mask determines which bits the pattern cares about. */
-    T mask(size_t wordnum) {
+    T mask(size_t wordnum) const {
         if (wordnum >= mask_.size())
             return 0;
         return mask_[wordnum];
     }
 
+    /** Returns the value of the significant bits of the specified word for one alternative. Words beyond the end of the
+     *  pattern have no significant bits and return zero. */
+    T pattern(size_t altnum, size_t wordnum) const {
+        assert(altnum < patterns_.size());
+        if (wordnum >= patterns_[altnum].size())
+            return 0;
+        return patterns_[altnum][wordnum] & mask_[wordnum];
+    }
+
     /** Returns invariant bits.  Given a set of of bits and a word number, this method returns values for bits that must be set
      *  or cleared and a mask indicating which bits are invariant.  For instance, if a pattern's alternatives all require that
      *  bits at positions 24 (inclusive) to 32 (exclusive) have the value 0xbe, don't care about bits at positions 8 to 24, and
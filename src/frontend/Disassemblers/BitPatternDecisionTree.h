@@ -0,0 +1,271 @@
+#ifndef ROSE_BitPatternDecisionTree_H
+#define ROSE_BitPatternDecisionTree_H
+
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include "BitPattern.h"
+
+#include <algorithm>
+#include <cassert>
+#include <iostream>
+#include <string>
+#include <vector>
+
+namespace Rose {
+
+/** Decision tree for finding the first of many bit patterns that matches some words.
+ *
+ *  Disassemblers built on @ref BitPattern typically have a list of instruction decoders, each with a pattern, and decode an
+ *  instruction by testing the patterns one at a time until one matches.  This class compiles such a list into a binary
+ *  decision tree over the bits of the first word so that finding the matching pattern takes at most one test per bit of the
+ *  first word, plus tests of any additional words needed by the few patterns that span more than one word.
+ *
+ *  Patterns are inserted in priority order, and @ref find returns the value of the first inserted pattern that matches, the
+ *  same answer as a linear search of the patterns in insertion order.  Inserting a pattern that can match exactly the same
+ *  words as an earlier pattern (see @ref BitPattern::any_same) is an ambiguity and is refused by @ref insert.  Once all the
+ *  patterns are inserted, @ref compile builds the tree, which can then be searched with @ref find.  Inserting another
+ *  pattern discards the tree, so it must be compiled again.
+ *
+ *  The tree is built by choosing a bit of the first word that the highest priority undecided pattern cares about (the one
+ *  that is significant for the most patterns) and partitioning the patterns by that bit; patterns that don't care about the
+ *  bit go to both sides. A subtree ends as soon as its highest priority pattern is fully decided and needs no other words,
+ *  since that pattern matches every input that reaches it.
+ *
+ *  The value type, @p V, is copied into the tree and must be copyable; it's usually a pointer to an instruction decoder. */
+template<typename T, typename V>
+class BitPatternDecisionTree {
+    // One alternative of one inserted pattern.
+    struct Entry {
+        size_t valueIdx;                                // index into values_ and patterns_
+        std::vector<T> masks;                           // significant bits for each word
+        std::vector<T> bits;                            // values of the significant bits for each word
+    };
+
+    // A node is either an interior node that tests one bit of the first word, or a leaf with a list of entries.
+    struct Node {
+        T bit;                                          // bit to test, or zero for a leaf
+        size_t child[2];                                // children for when the tested bit is clear or set
+        size_t begin, end;                              // range of leafEntries_ for a leaf
+        Node(): bit(0), begin(0), end(0) {
+            child[0] = child[1] = 0;
+        }
+    };
+
+    std::vector<BitPattern<T> > patterns_;              // patterns in the order they were inserted
+    std::vector<V> values_;                             // value for each pattern
+    std::vector<Entry> entries_;                        // pattern alternatives in priority order
+    std::vector<Node> nodes_;                           // the tree, rooted at nodes_[0]; empty if not compiled
+    std::vector<size_t> leafEntries_;                   // entries for each leaf, in priority order
+    size_t depth_;                                      // maximum depth of the tree
+
+public:
+    /** Construct an empty tree. */
+    BitPatternDecisionTree()
+        : depth_(0) {}
+
+    /** Remove all patterns. */
+    void clear() {
+        patterns_.clear();
+        values_.clear();
+        entries_.clear();
+        nodes_.clear();
+        leafEntries_.clear();
+        depth_ = 0;
+    }
+
+    /** Number of patterns inserted. */
+    size_t size() const {
+        return patterns_.size();
+    }
+
+    /** Whether the tree has been compiled since the last insertion. */
+    bool isCompiled() const {
+        return !nodes_.empty();
+    }
+
+    /** Number of nodes in the compiled tree. */
+    size_t nNodes() const {
+        return nodes_.size();
+    }
+
+    /** Maximum depth of the compiled tree, which is the maximum number of bit tests needed to reach a leaf. */
+    size_t depth() const {
+        return depth_;
+    }
+
+    /** Insert a pattern with a lower priority than all previous patterns.
+     *
+     *  If the pattern can match exactly the same words as a previously inserted pattern then it is not inserted, the value of
+     *  the earlier pattern is saved in @p conflict if it's non-null, and false is returned. Otherwise the pattern is inserted,
+     *  the tree is discarded if it had been compiled, and true is returned. */
+    bool insert(const BitPattern<T> &pattern, const V &value, V *conflict = NULL) {
+        for (size_t i = 0; i < patterns_.size(); ++i) {
+            if (pattern.any_same(patterns_[i])) {
+                if (conflict)
+                    *conflict = values_[i];
+                return false;
+            }
+        }
+
+        size_t valueIdx = patterns_.size();
+        patterns_.push_back(pattern);
+        values_.push_back(value);
+
+        size_t nAlternatives = std::max(pattern.nalternatives(), size_t(1)); // an empty pattern matches everything
+        for (size_t altnum = 0; altnum < nAlternatives; ++altnum) {
+            Entry entry;
+            entry.valueIdx = valueIdx;
+            for (size_t wordnum = 0; wordnum < std::max(pattern.nwords(), size_t(1)); ++wordnum) {
+                entry.masks.push_back(pattern.mask(wordnum));
+                entry.bits.push_back(pattern.nalternatives() > 0 ? pattern.pattern(altnum, wordnum) : T(0));
+            }
+            entries_.push_back(entry);
+        }
+
+        nodes_.clear();
+        leafEntries_.clear();
+        depth_ = 0;
+        return true;
+    }
+
+    /** Build the decision tree from the inserted patterns. */
+    void compile() {
+        nodes_.clear();
+        leafEntries_.clear();
+        depth_ = 0;
+        std::vector<size_t> candidates;
+        candidates.reserve(entries_.size());
+        for (size_t i = 0; i < entries_.size(); ++i)
+            candidates.push_back(i);
+        build(candidates, T(0), 0);
+    }
+
+    /** Find the first pattern that matches.
+     *
+     *  Returns a pointer to the value of the highest priority pattern that matches the specified words, or null if no pattern
+     *  matches. A pattern that spans more words than are supplied does not match. The tree must have been compiled. */
+    const V* find(const T *words, size_t nWords) const {
+        assert(isCompiled());
+        if (0 == nWords)
+            return NULL;
+        const T w0 = words[0];
+        const Node *node = &nodes_[0];
+        while (node->bit != 0)
+            node = &nodes_[node->child[(w0 & node->bit) != 0 ? 1 : 0]];
+        for (size_t i = node->begin; i < node->end; ++i) {
+            const Entry &entry = entries_[leafEntries_[i]];
+            if (entry.masks.size() > nWords)
+                continue;
+            bool matched = true;
+            for (size_t wordnum = 1; matched && wordnum < entry.masks.size(); ++wordnum)
+                matched = (words[wordnum] & entry.masks[wordnum]) == entry.bits[wordnum];
+            if (matched)
+                return &values_[entry.valueIdx];
+        }
+        return NULL;
+    }
+
+    /** Print the tree for debugging. */
+    void print(std::ostream &out) const {
+        if (!isCompiled()) {
+            out <<"not compiled\n";
+        } else {
+            print(out, 0, "");
+        }
+    }
+
+private:
+    // Build the subtree for the specified candidate entries (in priority order) given that the bits of the first word in
+    // decidedMask are known. Returns the index of the new node.
+    size_t build(const std::vector<size_t> &candidates, T decidedMask, size_t depth) {
+        size_t nodeIdx = nodes_.size();
+        nodes_.push_back(Node());
+        depth_ = std::max(depth_, depth);
+
+        // Find the first candidate whose first word isn't fully decided. Candidates before it always match the first word, and
+        // if any of them needs no other words then it's the answer for everything that reaches this node.
+        size_t nDecided = 0;
+        T splitMask = 0;
+        for (/*void*/; nDecided < candidates.size(); ++nDecided) {
+            const Entry &entry = entries_[candidates[nDecided]];
+            if ((splitMask = entry.masks[0] & ~decidedMask) != 0)
+                break;
+            if (entry.masks.size() == 1) {
+                ++nDecided;
+                splitMask = 0;
+                break;
+            }
+        }
+
+        if (0 == splitMask) {
+            Node &node = nodes_[nodeIdx];
+            node.begin = leafEntries_.size();
+            leafEntries_.insert(leafEntries_.end(), candidates.begin(), candidates.begin() + nDecided);
+            node.end = leafEntries_.size();
+            return nodeIdx;
+        }
+
+        // Of the bits needed to decide that candidate, split on the one that's significant for the most candidates.
+        T bit = 0;
+        size_t bestCount = 0;
+        for (size_t i = 0; i < 8*sizeof(T); ++i) {
+            T b = T(1) << i;
+            if ((splitMask & b) != 0) {
+                size_t count = 0;
+                for (size_t j = 0; j < candidates.size(); ++j) {
+                    if ((entries_[candidates[j]].masks[0] & b) != 0)
+                        ++count;
+                }
+                if (0 == bit || count > bestCount) {
+                    bit = b;
+                    bestCount = count;
+                }
+            }
+        }
+
+        std::vector<size_t> sides[2];
+        for (size_t i = 0; i < candidates.size(); ++i) {
+            const Entry &entry = entries_[candidates[i]];
+            if ((entry.masks[0] & bit) == 0) {
+                sides[0].push_back(candidates[i]);
+                sides[1].push_back(candidates[i]);
+            } else {
+                sides[(entry.bits[0] & bit) != 0 ? 1 : 0].push_back(candidates[i]);
+            }
+        }
+
+        size_t child0 = build(sides[0], decidedMask | bit, depth + 1);
+        size_t child1 = build(sides[1], decidedMask | bit, depth + 1);
+        Node &node = nodes_[nodeIdx];                   // not earlier since recursion may reallocate nodes_
+        node.bit = bit;
+        node.child[0] = child0;
+        node.child[1] = child1;
+        return nodeIdx;
+    }
+
+    void print(std::ostream &out, size_t nodeIdx, const std::string &prefix) const {
+        const Node &node = nodes_[nodeIdx];
+        if (node.bit != 0) {
+            out <<prefix <<"bit " <<Rose::StringUtility::addrToString(node.bit, 8*sizeof(T)) <<" clear:\n";
+            print(out, node.child[0], prefix + "  ");
+            out <<prefix <<"bit " <<Rose::StringUtility::addrToString(node.bit, 8*sizeof(T)) <<" set:\n";
+            print(out, node.child[1], prefix + "  ");
+        } else {
+            out <<prefix <<"try";
+            if (node.begin == node.end)
+                out <<" nothing";
+            for (size_t i = node.begin; i < node.end; ++i) {
+                const Entry &entry = entries_[leafEntries_[i]];
+                out <<" ";
+                patterns_[entry.valueIdx].print(out);
+            }
+            out <<"\n";
+        }
+    }
+};
+
+} // namespace
+
+#endif
+#endif
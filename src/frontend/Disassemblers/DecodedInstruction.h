@@ -0,0 +1,118 @@
+#ifndef ROSE_BinaryAnalysis_DecodedInstruction_H
+#define ROSE_BinaryAnalysis_DecodedInstruction_H
+#include <featureTests.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include "RegisterDescriptor.h"
+
+#include <cstring>
+#include <string>
+
+namespace Rose {
+namespace BinaryAnalysis {
+
+/** One operand of a @ref DecodedInstruction.
+ *
+ *  Operands are described only to the extent that most bulk analyses need: registers, constants, and memory references whose
+ *  address is a sum of an optional base register, an optional scaled index register, and a constant displacement.  Anything
+ *  else is described as an @ref OTHER operand, in which case the caller must promote the instruction to an AST to learn
+ *  more. */
+struct DecodedOperand {
+    /** Kind of operand. */
+    enum Kind {
+        NONE,                                           /**< Operand is not present. */
+        REGISTER,                                       /**< Register stored in @ref base. */
+        IMMEDIATE,                                      /**< Constant stored in @ref value. */
+        MEMORY,                                         /**< Memory at base + index * scale + value. */
+        OTHER                                           /**< Operand that cannot be described by this struct. */
+    };
+
+    Kind kind;                                          /**< Kind of operand. */
+    unsigned nBits;                                     /**< Width of the register, constant, or memory value. */
+    RegisterDescriptor base;                            /**< Register, or base register of a memory address. Possibly empty. */
+    RegisterDescriptor index;                           /**< Index register of a memory address. Possibly empty. */
+    RegisterDescriptor segment;                         /**< Segment register of a memory address. Possibly empty. */
+    unsigned scale;                                     /**< Multiplier for the index register. */
+    uint64_t value;                                     /**< Constant, or sign-extended displacement of an address. */
+
+    /** Reset to the @ref NONE state. */
+    void clear() {
+        kind = NONE;
+        nBits = 0;
+        base = index = segment = RegisterDescriptor();
+        scale = 0;
+        value = 0;
+    }
+};
+
+/** Compact description of a decoded instruction.
+ *
+ *  Many analyses that decode large numbers of instructions, such as linear sweeps, entropy scans, and searches for byte
+ *  patterns, need only an instruction's size, kind, and control flow successors. Creating a full @ref SgAsmInstruction AST
+ *  for each one is relatively expensive in both time and memory, and ROSE makes it hard to free those ASTs afterward.  This
+ *  struct holds the commonly needed information by value, with its operands stored inline, so it can be copied, stored in
+ *  arrays, and discarded freely. It is produced by @ref Disassembler::decode and can be promoted to an AST by @ref
+ *  Disassembler::makeAst, which decodes the saved bytes again.
+ *
+ *  The @ref kind is the architecture-specific instruction kind, the same value returned by @ref SgAsmInstruction::get_anyKind
+ *  (e.g., an @ref X86InstructionKind for x86 instructions). */
+struct DecodedInstruction {
+    /** Maximum number of instruction bytes that can be stored. This is the size of the largest instruction of any supported
+     *  architecture, namely an m68k instruction with ten extension words. */
+    static const size_t maxBytes = 22;
+
+    /** Maximum number of operands that can be stored. Operands beyond this number are not described. */
+    static const size_t maxOperands = 4;
+
+    /** Maximum length of mnemonic, including the NUL terminator. Longer mnemonics are truncated. */
+    static const size_t maxMnemonic = 16;
+
+    /** Maximum number of successors that can be stored. */
+    static const size_t maxSuccessors = 2;
+
+    rose_addr_t address;                                /**< Starting address of the instruction. */
+    size_t size;                                        /**< Number of bytes in the instruction. */
+    uint8_t bytes[maxBytes];                            /**< Instruction encoding; the first @ref size bytes are valid. */
+    unsigned kind;                                      /**< Architecture-specific instruction kind. */
+    char mnemonic[maxMnemonic];                         /**< NUL-terminated, possibly truncated mnemonic. */
+    size_t nOperands;                                   /**< Total number of operands, possibly more than @ref maxOperands. */
+    DecodedOperand operands[maxOperands];               /**< Descriptions of the first operands. */
+    bool isUnknown;                                     /**< True if the bytes could not be decoded. */
+    bool terminatesBasicBlock;                          /**< True if the instruction ends a basic block. */
+    bool isFunctionCall;                                /**< True if the instruction is a function call. */
+    bool isFunctionReturn;                              /**< True if the instruction is a function return. */
+    bool successorsComplete;                            /**< True if the successors are known and are all listed. */
+    size_t nSuccessors;                                 /**< Number of successors listed in @ref successors. */
+    rose_addr_t successors[maxSuccessors];              /**< Known successor addresses, in increasing order. */
+
+    /** Reset all members to zero values. */
+    void clear() {
+        address = 0;
+        size = 0;
+        memset(bytes, 0, sizeof bytes);
+        kind = 0;
+        memset(mnemonic, 0, sizeof mnemonic);
+        nOperands = 0;
+        for (size_t i = 0; i < maxOperands; ++i)
+            operands[i].clear();
+        isUnknown = terminatesBasicBlock = isFunctionCall = isFunctionReturn = successorsComplete = false;
+        nSuccessors = 0;
+        memset(successors, 0, sizeof successors);
+    }
+
+    /** Fall-through address. */
+    rose_addr_t fallThrough() const {
+        return address + size;
+    }
+
+    /** Mnemonic as a string. */
+    std::string mnemonicString() const {
+        return std::string(mnemonic);
+    }
+};
+
+} // namespace
+} // namespace
+
+#endif
+#endif
@@ -5,6 +5,7 @@
 
 #include "BinaryCallingConvention.h"
 #include "BinaryUnparser.h"
+#include "DecodedInstruction.h"
 #include "Diagnostics.h"                                // Rose::Diagnostics
 #include "MemoryMap.h"
 #include "Registers.h"
@@ -331,6 +332,36 @@ public:
     SgAsmInstruction *disassembleOne(const unsigned char *buf, rose_addr_t buf_va, size_t buf_size, rose_addr_t start_va,
                                      AddressSet *successors=NULL);
 
+    /** Decode one instruction without keeping its AST.
+     *
+     *  Decodes the instruction at the specified virtual address and describes it in the caller-supplied @p insn struct, which
+     *  is more compact than an @ref SgAsmInstruction AST and is easily copied and discarded. This is intended for analyses that
+     *  decode many instructions but need little more than their sizes, kinds, and successors.  Error handling is the same as
+     *  for @ref disassembleOne: bytes that don't form a valid instruction produce an unknown instruction, and an exception is
+     *  thrown if no instruction can be decoded at the address.
+     *
+     *  The default implementation calls @ref disassembleOne, describes the resulting AST, and then deletes the AST. Subclasses
+     *  may override this to decode directly into the struct, as @ref DisassemblerM68k and @ref DisassemblerX86 do for their
+     *  most common instructions.
+     *
+     *  Thread safety: Same as @ref disassembleOne. */
+    virtual void decode(const MemoryMap::Ptr &map, rose_addr_t start_va, DecodedInstruction &insn /*out*/);
+
+    /** Create an AST for a decoded instruction.
+     *
+     *  Decodes the bytes saved in @p insn at the instruction's address and returns the resulting AST, which is the same as what
+     *  @ref disassembleOne would have returned for the original memory.  The caller owns the returned AST.
+     *
+     *  Thread safety: Same as @ref disassembleOne. */
+    SgAsmInstruction* makeAst(const DecodedInstruction &insn);
+
+    /** Describe an instruction AST.
+     *
+     *  Fills in @p insn from the specified instruction AST, which is not modified. The successors are computed by @ref
+     *  SgAsmInstruction::getSuccessors; if there are more than @ref DecodedInstruction::maxSuccessors then none are listed and
+     *  the list is marked as incomplete. */
+    static void describe(SgAsmInstruction*, DecodedInstruction &insn /*out*/);
+
 
     /***************************************************************************************************************************
      *                                          Miscellaneous methods
@@ -6,7 +6,7 @@
 #ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
 
 #include "InstructionEnumsM68k.h"
-#include "BitPattern.h"
+#include "BitPatternDecisionTree.h"
 
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/base_object.hpp>
@@ -50,6 +50,11 @@ public:
         BitPattern<uint16_t> pattern;                   // bits that match
         typedef DisassemblerM68k D;
         virtual SgAsmM68kInstruction *operator()(State&, const D *d, unsigned w0) = 0;
+
+        /** Describe the instruction without building its AST. Returns false if this instruction-specific disassembler can't,
+         *  in which case @ref DisassemblerM68k::decode describes the AST built by operator() instead. Common instructions
+         *  override this; the default returns false. */
+        virtual bool decode(State&, const D *d, unsigned w0, DecodedInstruction &insn /*out*/) { return false; }
     };
 
 private:
@@ -64,6 +69,11 @@ private:
     typedef std::vector<IdisList> IdisTable;
     IdisTable idis_table;
 
+    // The same instruction disassemblers compiled into a decision tree that's searched by find_idis. The tree is built from
+    // the table by compile_idis and finds the same disassembler as searching the table's lists in order.
+    typedef BitPatternDecisionTree<uint16_t, M68k*> IdisTree;
+    IdisTree idis_tree;
+
 #ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
 private:
     friend class boost::serialization::access;
@@ -114,6 +124,13 @@ public:
     virtual SgAsmInstruction *makeUnknownInstruction(const Disassembler::Exception&) ROSE_OVERRIDE;
     virtual Unparser::BasePtr unparser() const ROSE_OVERRIDE;
 
+    /** Decode one instruction without building its AST.
+     *
+     *  Instructions whose instruction-specific disassembler has a @ref M68k::decode method are described directly from their
+     *  instruction words. All others, and any instruction that can't be decoded, go through the AST as in the base class, so
+     *  the result is always the same as describing what @ref disassembleOne returns. */
+    virtual void decode(const MemoryMap::Ptr&, rose_addr_t start_va, DecodedInstruction &insn /*out*/) ROSE_OVERRIDE;
+
     typedef std::pair<SgAsmExpression*, SgAsmExpression*> ExpressionPair;
 
     /** Find an instruction-specific disassembler.  Using the specified instruction bits, search for and return an
@@ -122,9 +139,14 @@ public:
     M68k *find_idis(uint16_t *insn_bytes, size_t nbytes) const;
 
     /** Insert an instruction-specific disassembler. The table must not already contain an entry that has the same @p mask and
-     *  @p match values. The pointers are managed by the caller and must not be deleted while they are in the table. */
+     *  @p match values. The pointers are managed by the caller and must not be deleted while they are in the table. If the
+     *  decision tree has already been compiled, it's compiled again. */
     void insert_idis(M68k*);
 
+    /** Compile the instruction-specific disassemblers into the decision tree used by @ref find_idis.  This is called by the
+     *  constructor after all built-in disassemblers are inserted. */
+    void compile_idis();
+
     /** Called by disassembleOne() to initialize the disassembler state for the next instruction. */
     void start_instruction(State &state, const MemoryMap::Ptr &map, rose_addr_t start_va) const{
         state.map = map;
@@ -233,6 +255,30 @@ public:
                                           SgAsmExpression *arg3=NULL, SgAsmExpression *arg4=NULL, SgAsmExpression *arg5=NULL,
                                           SgAsmExpression *arg6=NULL) const;
 
+    /** Describe an effective address without building an expression.
+     *
+     *  Same arguments as @ref makeEffectiveAddress, but the result is stored in @p op as @ref Disassembler::describe would
+     *  describe the expression. Returns false for modes that are not described this way, namely the indexed modes and those
+     *  that @ref makeEffectiveAddress rejects, leaving those to the AST.
+     *
+     * @{ */
+    bool decodeEffectiveAddress(State&, unsigned modreg, M68kDataFormat fmt, size_t ext_offset, DecodedOperand &op /*out*/) const;
+    bool decodeEffectiveAddress(State&, unsigned mode, unsigned reg, M68kDataFormat fmt, size_t ext_offset,
+                                DecodedOperand &op /*out*/) const;
+    /** @} */
+
+    /** Describe an integer constant like @ref makeImmediateValue does. */
+    void decodeImmediateValue(M68kDataFormat fmt, uint64_t value, DecodedOperand &op /*out*/) const;
+
+    /** Describe the target of a JMP or JSR like @ref makeAddress does. Returns false if that can't be done without the AST. */
+    bool decodeAddress(State&, unsigned modreg, DecodedOperand &op /*out*/) const;
+
+    /** Finish describing an instruction whose first @p nOperands operands are already stored in @p insn. Fills in the address,
+     *  bytes, kind, and mnemonic, and the control flow information that @ref SgAsmM68kInstruction would compute from the
+     *  kind and branch target. */
+    void decodeInstruction(State&, M68kInstructionKind, const std::string &mnemonic, size_t nOperands,
+                           DecodedInstruction &insn /*out*/) const;
+
     /** Returns ISA family specified in constructor. */
     M68kFamily get_family() const { return family; }
 
@@ -119,6 +119,14 @@ public:
 
     virtual SgAsmInstruction *makeUnknownInstruction(const Exception&) ROSE_OVERRIDE;
 
+    /** Decode one instruction without building its AST.
+     *
+     *  The most common prefix-free instructions (nop, push and pop of a register, leave, int3, hlt, ret, and the relative
+     *  forms of call, jmp, and the conditional jumps) are described directly from their bytes. All others, and any
+     *  instruction that can't be decoded, go through the AST as in the base class, so the result is always the same as
+     *  describing what @ref disassembleOne returns. */
+    virtual void decode(const MemoryMap::Ptr&, rose_addr_t start_va, DecodedInstruction &insn /*out*/) ROSE_OVERRIDE;
+
 
     /*========================================================================================================================
      * Data types
@@ -347,6 +355,26 @@ private:
 
 
 
+    /*========================================================================================================================
+     * Methods that describe an instruction without building an AST. (Their names all start with "decode".)
+     *========================================================================================================================*/
+private:
+
+    /** Describes the instruction in @p buf if it is one of the common instructions handled by @ref decode. Returns false,
+     *  leaving @p insn in an unspecified state, for all other instructions. */
+    bool decodeCommon(rose_addr_t va, const uint8_t *buf, size_t bufsz, DecodedInstruction &insn /*out*/) const;
+
+    /** Describes a register operand the same way as an expression built by @ref makeRegister. */
+    void decodeRegister(const std::string &name, size_t nBits, DecodedOperand &op /*out*/) const;
+
+    /** Describes a constant operand of the given width, such as a branch target built by getImmJb or getImmJz. */
+    void decodeImmediateValue(uint64_t value, size_t nBits, DecodedOperand &op /*out*/) const;
+
+    /** Fills in everything but the operands. The operands must already be described because the successors of branches
+     *  are computed from them, in the same way as SgAsmX86Instruction::getSuccessors. */
+    void decodeInstruction(rose_addr_t va, const uint8_t *buf, size_t size, X86InstructionKind kind, const char *mnemonic,
+                           size_t nOperands, DecodedInstruction &insn /*in,out*/) const;
+
     /*========================================================================================================================
      * Main disassembly functions, each generally containing a huge "switch" statement based on one of the opcode bytes.
      *========================================================================================================================*/
@@ -793,7 +793,8 @@ public:
      *  Scans read-only data beginning at the specified address in order to find pointers to code, and makes a new function at
      *  when found.  The pointer must be word aligned and located in memory that's mapped read-only (not writable and not
      *  executable), and it must not point to an unknown instruction or an instruction that overlaps with any instruction
-     *  that's already in the CFG/AUM.
+     *  that's already in the CFG/AUM. The instruction at each candidate address is examined with @ref
+     *  InstructionProvider::decode, so candidates that are rejected don't leave instruction ASTs in the partitioner's cache.
      *
      *  Returns a pointer to a newly-allocated function that has not yet been attached to the CFG/AUM, or a null pointer if no
      *  function was found.  In any case, the startVa is updated so it points to the next read-only address to check.
@@ -919,7 +920,8 @@ public:
      *
      *  This method scans the unused address intervals (those addresses that are not represented by the CFG/AUM). For each
      *  unused interval, if the interval is immediately surrounded by a single function then a basic block placeholder is
-     *  created at the beginning of the interval and added to the function.
+     *  created at the beginning of the interval and added to the function. Each function that receives new placeholders is
+     *  detached from and reattached to the partitioner only once.
      *
      *  Returns the number of new placeholders created. */
     virtual size_t attachSurroundedCodeToFunctions(Partitioner&);
@@ -927,7 +929,11 @@ public:
     /** Attach basic blocks to functions.
      *
      *  Calls @ref Partitioner::discoverFunctionBasicBlocks once for each known function the partitioner's CFG/AUM in a
-     *  sophomoric attempt to assign existing basic blocks to functions. */
+     *  sophomoric attempt to assign existing basic blocks to functions.
+     *
+     *  The search for each function's blocks only reads the CFG, so it is performed by worker threads according to the
+     *  global "--threads" switch. The results are then added to the functions serially in the order the functions are
+     *  stored in the partitioner, so the final partitioning does not depend on the number of threads. */
     virtual void attachBlocksToFunctions(Partitioner&);
 
     /** Attach dead code to functions.
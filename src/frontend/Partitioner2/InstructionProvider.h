@@ -134,6 +134,14 @@ public:
      *  are not executable. */
     SgAsmInstruction* operator[](rose_addr_t va) const;
 
+    /** Describes the instruction at the specified virtual address without caching it.
+     *
+     *  Returns false wherever @ref operator[] would return a null pointer. Otherwise @p insn describes the cached instruction
+     *  if there is one, or else what the disassembler decodes at that address, including a one-byte "unknown" instruction if
+     *  nothing valid can be decoded. Unlike @ref operator[], decoding an uncached instruction neither builds a lasting AST nor
+     *  adds it to the cache, so this is suited to scans that examine many candidate addresses and keep few of them. */
+    bool decode(rose_addr_t va, DecodedInstruction &insn /*out*/) const;
+
     /** Insert an instruction into the cache.
      *
      *  This instruction provider saves a pointer to the instruction without taking ownership.  If an instruction already
@@ -1904,6 +1904,20 @@ public:
      *  Thread safety: Not thread safe. */
     void discoverFunctionBasicBlocks(const Function::Ptr &function) const /*final*/;
 
+    /** Finds basic blocks that could be added to a function.
+     *
+     *  This is the read-only part of @ref discoverFunctionBasicBlocks: it follows the CFG from the vertices already owned by
+     *  the function using the same rules, but instead of modifying the function it returns the starting addresses of the
+     *  basic blocks that would be added, in order of CFG vertex ID. Thunks are not treated specially; callers should check
+     *  @ref functionIsThunk first since that method may adjust the thunk's outgoing edge.
+     *
+     *  Neither the CFG nor the function are modified, and the function may be attached to or detached from the CFG. Since
+     *  only the owned vertices and the entry vertices of all functions influence the result, the answer for one function does
+     *  not depend on which other functions have already had their blocks discovered.
+     *
+     *  Thread safety: Thread safe provided no other thread is modifying the CFG or the function. */
+    std::vector<rose_addr_t> discoverFunctionBasicBlockAddresses(const Function::Ptr &function) const /*final*/;
+
     /** Returns ghost successors for a single function.
      *
      *  Returns the set of basic block starting addresses that are naive successors for the basic blocks of a function but
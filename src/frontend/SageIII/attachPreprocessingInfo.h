@@ -21,6 +21,15 @@ ROSEAttributesList *getPreprocessorDirectives( std::string fileName );
 
 void attachPreprocessingInfo(SgSourceFile *sageFile);
 
+// Same as above, but uses an index of the AST (see AttachPreprocessingInfoIndex) to visit only the subtrees that have nodes
+// from this file. The index must cover the AST reachable from the file and must be up to date.
+void attachPreprocessingInfo(SgSourceFile *sageFile, const AttachPreprocessingInfoIndex* index);
+
+// Attach the comments and CPP directives of several files (e.g. a source file and its header files) that share an AST.
+// The AST is indexed once, so each file costs time proportional to the part of the AST from that file rather than to the
+// whole AST.
+void attachPreprocessingInfo(const std::vector<SgSourceFile*> & sageFiles);
+
 // DQ (11/30/2008): Part of refactoring of code specific to Wave.
 void attachPreprocessingInfoUsingWave(SgSourceFile *sageFile);
 
@@ -1,6 +1,10 @@
 #ifndef _ATTACH_PREPROCESSING_INFO_TRAVERSAL_H_
 #define _ATTACH_PREPROCESSING_INFO_TRAVERSAL_H_
 
+#include <boost/unordered_map.hpp>
+#include <set>
+#include <vector>
+
 // DQ (4/5/2006): Andreas has removed this code!
 
 // void printOutComments ( SgLocatedNode* locatedNode );
@@ -75,6 +79,41 @@ class AttachPreprocessingInfoTreeTraversalInheritedAttrribute
 // This is an empty class, meaning that we could likely just have implemented just a TopDownProcessing traversal.
 class AttachPreprocessingInfoTreeTraversalSynthesizedAttribute {};
 
+// Index of which files contribute located nodes to each subtree of the AST.
+// Comments and CPP directives are attached one file at a time (the source file and then each header file), and each time
+// the traversal used to visit the whole AST even though only the nodes from that one file can receive them. With an index
+// the traversal skips every subtree that has no located nodes from the file being processed, so the work for each file is
+// proportional to the part of the AST that came from it (plus its ancestors) instead of to the whole AST.
+// The index is built once (a single bottom-up pass) and can then be shared by the attachment for any number of files.
+// Each subtree maps to a sorted list of file ids that is searched with a binary search; lists are shared between subtrees
+// with the same set of files, so the index needs little more than one hash table entry per IR node.
+class AttachPreprocessingInfoIndex
+   {
+     public:
+       // Sorted and unique physical file ids.
+          typedef std::vector<int> FileIdList;
+
+     private:
+          boost::unordered_map<SgNode*, const FileIdList*> subtreeFileIds;
+          std::set<FileIdList> uniqueFileIdLists;
+
+          const FileIdList* intern(const FileIdList & fileIds);
+          const FileIdList* indexSubtree(SgNode* node);
+
+     public:
+          AttachPreprocessingInfoIndex();
+
+       // Add the subtree rooted at the node. Subtrees that are already indexed (e.g. shared between files) are not revisited.
+          void insert(SgNode* root);
+
+       // True if the subtree rooted at the node might have located nodes from the file.  Subtrees that are not indexed
+       // (e.g. added to the AST after the index was built) are conservatively assumed to have nodes from all files.
+          bool mayContainFile(SgNode* node, int fileId) const;
+
+       // Number of indexed subtrees (IR nodes).
+          size_t size() const;
+   };
+
 class AttachPreprocessingInfoTreeTrav 
    : public SgTopDownBottomUpProcessing<AttachPreprocessingInfoTreeTraversalInheritedAttrribute,
                                         AttachPreprocessingInfoTreeTraversalSynthesizedAttribute>
@@ -146,6 +185,12 @@ class AttachPreprocessingInfoTreeTrav
        // include files (except should specified using exclusion lists via the command line).
           bool processAllIncludeFiles;
 
+       // Optional index used to skip subtrees that have no located nodes from the target file (NULL to visit everything).
+          const AttachPreprocessingInfoIndex* attachmentIndex;
+
+       // Prune the successors of a node using the attachment index.
+          virtual void setNodeSuccessors(SgNode* node, SuccessorsContainer & succContainer);
+
      public:
        // DQ (9/24/2007): Moved function definition to source file from header file.
        // AS(011306) Constructor for use of Wave Preprocessor
@@ -161,6 +206,10 @@ class AttachPreprocessingInfoTreeTrav
        // Constructor
        // AttachPreprocessingInfoTreeTrav( SgSourceFile* file, bool includeDirectivesAndCommentsFromAllFiles );
           AttachPreprocessingInfoTreeTrav( SgSourceFile* file, ROSEAttributesList* listOfAttributes );
+
+       // Use an index (built by the caller and covering the AST to be traversed) to skip subtrees with nothing from
+       // the target file. The index must outlive the traversal. Passing NULL restores the full traversal.
+          void set_attachmentIndex(const AttachPreprocessingInfoIndex* index);
 #if 0
           AttachPreprocessingInfoTreeTrav();
 #endif
@@ -2508,6 +2508,20 @@ SgProject::parse()
   // to be output before preprocessing information is attached.
      SgFilePtrList & files = get_fileList();
 
+  // Index the AST once so that attaching the comments and CPP directives of each file visits only the part of the AST from
+  // that file instead of the whole AST (which also has the declarations from all the header files and the other source files).
+     AttachPreprocessingInfoIndex attachmentIndex;
+        {
+          TimingPerformance timer ("AST Comment and CPP Directive Processing (indexing the AST):");
+          BOOST_FOREACH(SgFile* file, files)
+             {
+               if (isSgSourceFile(file) != NULL && file->get_disable_edg_backend() == false && file->get_skip_commentsAndDirectives() == false)
+                  {
+                    attachmentIndex.insert(file);
+                  }
+             }
+        }
+
      BOOST_FOREACH(SgFile* file, files)
         {
           ROSE_ASSERT(file != NULL);
@@ -2599,7 +2613,7 @@ SgProject::parse()
                     printf ("Processing comments and CPP directives for source file \n");
                     printf ("###################################################### \n");
 #endif
-                    file->secondaryPassOverSourceFile();
+                    file->secondaryPassOverSourceFile(attachmentIndex.size() > 0 ? &attachmentIndex : NULL);
 #if 0
                     printf ("Exiting after test! processed first phase of collecting comments and CPP directives for source file) \n");
                     ROSE_ASSERT(false);
@@ -3463,7 +3477,7 @@ SgFile::callFrontEnd()
 
 
 void
-SgFile::secondaryPassOverSourceFile()
+SgFile::secondaryPassOverSourceFile(const AttachPreprocessingInfoIndex* attachmentIndex)
    {
   // DQ (8/19/2019): We want to optionally seperate this function out over two phases to optimize the support for header file unparsing.
   // When not optimized, we process all of the header file with the source file.
@@ -3655,7 +3669,7 @@ SgFile::secondaryPassOverSourceFile()
 #if 0
                     printf ("@@@@@@@@@@@@@@ In SgFile::secondaryPassOverSourceFile(): Calling attachPreprocessingInfo(): sourceFile = %p = %s \n",sourceFile,sourceFile->class_name().c_str());
 #endif
-                    attachPreprocessingInfo(sourceFile);
+                    attachPreprocessingInfo(sourceFile,attachmentIndex);
 #if 0
                     printf ("@@@@@@@@@@@@@@ DONE: In SgFile::secondaryPassOverSourceFile(): Calling attachPreprocessingInfo(): sourceFile = %p = %s \n",sourceFile,sourceFile->class_name().c_str());
 #endif
@@ -7873,8 +7887,14 @@ int SgProject::link ( const std::vector<std::string>& argv, std::string linkerNa
   // There will be no SgFile at all in this case but we still want to append relevant linking options for OpenMP
      if (get_openmp_linking())
         {
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+       // libxomp.a carries its own runtime, which only needs pthreads
+          string xomp_lib_path(ROSE_INSTALLATION_PATH);
+          ROSE_ASSERT (xomp_lib_path.size() != 0);
+          linkingCommand.push_back(xomp_lib_path+"/lib/libxomp.a");
+          linkingCommand.push_back("-lpthread");
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 // Sara Royuela 12/10/2012:  Add GCC version check
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY
 #if (__GNUC__ < 4 || (__GNUC__ == 4 && (__GNUC_MINOR__ < 4)))
 #warning "GNU version lower than expected"
           printf("GCC version must be 4.4.0 or later when linking with GOMP OpenMP Runtime Library \n(OpenMP tasking calls are not implemented in previous versions)\n");
@@ -24,6 +24,7 @@
 
 // Non-ROSE headers
 #include <boost/filesystem.hpp>
+#include <boost/function.hpp>
 
 #ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
 #include <boost/serialization/export.hpp>
@@ -39,8 +40,10 @@
 #include <boost/numeric/conversion/cast.hpp>
 #include <memory>
 #include <Sawyer/BiMap.h>
+#include <Sawyer/Map.h>
 #include <Sawyer/SharedObject.h>
 #include <Sawyer/SharedPointer.h>
+#include <Sawyer/Stopwatch.h>
 #include <Sawyer/Synchronization.h>
 #include <stdexcept>
 #include <string>
@@ -129,6 +132,9 @@ typedef Sawyer::SharedPointer<ExecutionManager> ExecutionManagerPtr;
 class LinuxExitStatus;
 typedef Sawyer::SharedPointer<LinuxExitStatus> LinuxExitStatusPtr;
 
+class ParallelExecutionManager;
+typedef Sawyer::SharedPointer<ParallelExecutionManager> ParallelExecutionManagerPtr;
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 // Specimens
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -145,11 +151,16 @@ public:
     /** Binary data, such as for the specimen content. */
     typedef std::vector<uint8_t> BinaryData;
 
+    /** Function that produces specimen content on demand. */
+    typedef boost::function<BinaryData()> ContentLoader;
+
 private:
     mutable SAWYER_THREAD_TRAITS::Mutex mutex_;         // protects the following data members
     std::string name_;                                  // name of specimen (e.g., for debugging)
     std::string timestamp_;                             // time of creation
-    BinaryData content_;                                // content of the binary executable file
+    mutable BinaryData content_;                        // content of the binary executable file, loaded lazily
+    mutable std::string contentHash_;                   // SHA-256 of content_, or empty if not computed yet
+    mutable ContentLoader contentLoader_;               // loads content_ on first use, or empty if already loaded
     mutable bool read_only_;                            // safe guards from writing content after it has been shared;
     bool empty_;                                        // indicates if this object is empty
 
@@ -158,6 +169,8 @@ private:
 
     template<class S>
     void serialize(S &s, const unsigned /*version*/) {
+        SAWYER_THREAD_TRAITS::LockGuard lock(mutex_);
+        loadContent();
         s & BOOST_SERIALIZATION_NVP(name_);
         s & BOOST_SERIALIZATION_NVP(content_);
         s & BOOST_SERIALIZATION_NVP(empty_);
@@ -244,6 +257,35 @@ public:
     /** The setter helps to conveniently populate a Specimen's properties
      *  from a database query. */
     void content(std::vector<uint8_t> binary_data);
+
+    /** Set content that will be loaded on demand.
+     *
+     *  Arranges for the content to be obtained by calling @p loader the first time it's needed, such as when @ref content is
+     *  called. The @p hash is the SHA-256 of the content as returned by @ref contentHash and is used to identify the content
+     *  without loading it. If the specimen already has the content with this hash, then it's kept and the loader is not
+     *  used. Databases use this so that reading a specimen doesn't read its (large) executable until an executor needs it.
+     *
+     *  Thread safety: This method is thread-safe. */
+    void content(const std::string &hash, const ContentLoader &loader);
+
+    /** Hash of the specimen content.
+     *
+     *  Returns the SHA-256 of the content as a string of hexadecimal characters, or an empty string if the specimen has no
+     *  content. Specimens with the same content have the same hash, so the hash is used as the key for storing content only
+     *  once. The hash is computed the first time it's needed and remembered, and it does not cause lazy content to be loaded.
+     *
+     *  Thread safety: This method is thread-safe. */
+    std::string contentHash() const;
+
+    /** Whether the content is loaded.
+     *
+     *  Returns false if the content was set by @ref content with a loader and hasn't been needed yet.
+     *
+     *  Thread safety: This method is thread-safe. */
+    bool isContentLoaded() const;
+
+private:
+    void loadContent() const;                           // caller must hold mutex_
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -636,11 +678,16 @@ public:
 
 protected:
     bool useAddressRandomization_;                      // enable/disable address space randomization in the OS
+    bool cacheSpecimens_;                               // write each specimen to a file once and reuse it
+    Sawyer::Container::Map<Specimen::Ptr, boost::filesystem::path> specimenFiles_; // cached executables
+    size_t nSpecimenFilesWritten_;                      // number of times a specimen was written to an executable file
 
 protected:
     explicit LinuxExecutor(const DatabasePtr&);
 
 public:
+    ~LinuxExecutor();
+
     /** Allocating constructor. */
     static Ptr instance(const DatabasePtr&);
 
@@ -654,8 +701,32 @@ public:
     void useAddressRandomization(bool b) { useAddressRandomization_ = b; }
     /** @} */
 
+    /** Property: Reuse specimen executable files.
+     *
+     *  A specimen's content must be written to an executable file before it can be run. If this property is set (the
+     *  default) then each specimen is written only the first time one of its test cases runs, and the file is removed when
+     *  this executor is destroyed. If clear, the file is written and removed again for every test case.
+     *
+     * @{ */
+    bool cacheSpecimens() const { return cacheSpecimens_; }
+    void cacheSpecimens(bool b) { cacheSpecimens_ = b; }
+    /** @} */
+
+    /** Number of executable files written.
+     *
+     *  Counts every time a specimen's content was written to an executable file by this executor. */
+    size_t nSpecimenFilesWritten() const { return nSpecimenFilesWritten_; }
+
+    /** Execute one test case synchronously.
+     *
+     *  The specimen is started with vfork and exec so that the cost of starting it doesn't depend on the size of the calling
+     *  process, which is usually large when it also does the concolic analysis. */
     virtual
     Result* execute(const TestCase::Ptr&) ROSE_OVERRIDE;
+
+private:
+    // Executable file for the specimen, written if necessary. Sets @p isTemporary if the caller must remove it.
+    boost::filesystem::path specimenFile(const Specimen::Ptr&, const std::string &basename, bool &isTemporary /*out*/);
 };
 
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -852,7 +923,12 @@ struct ObjectTraits<TestCase> {
  *
  *  Objects within a database have an ID number, and these ID numbers are type-specific. When an object is inserted (copied)
  *  into a database a new ID number is returned. The @ref Database object memoizes the association between object IDs and
- *  objects. */
+ *  objects.
+ *
+ *  Large values such as specimen content and long argument lists or environments are stored only once per distinct value,
+ *  keyed by their SHA-256 hash, no matter how many specimens or test cases refer to them. Reading a specimen from the
+ *  database doesn't read its content; that happens when the content is first used (see @ref Specimen::content). (Version 2
+ *  databases only.) */
 class Database: public Sawyer::SharedObject, public Sawyer::SharedFromThis<Database>, boost::noncopyable {
 public:
     /** Reference counting pointer to @ref Database. */
@@ -1128,6 +1204,71 @@ public:
     */
    bool hasUntested();
 
+#if ROSE_CONCOLIC_DB_VERSION == 2
+    //------------------------------------------------------------------------------------------------------------------------
+    // Claiming work. Test cases are leased to workers so that several processes can share one database.
+    //------------------------------------------------------------------------------------------------------------------------
+
+    /** Claim test cases that need concrete testing.
+     *
+     *  Claims up to @p n test cases that have no concrete results and are not claimed by another worker, and returns their
+     *  IDs.  The claims are recorded in the database under the name @p worker, which should be unique among all processes
+     *  using the database, and they expire after @p leaseSeconds so that the test cases of a worker that died are eventually
+     *  claimed by another. Each test case is claimed with a single conditional update, which is atomic in every supported
+     *  database, so no two workers hold an unexpired claim on the same test case.
+     *
+     *  Thread safety: Not thread safe. Each thread or process should use its own database connection. */
+    std::vector<TestCaseId> claimConcreteTesting(size_t n, const std::string &worker, unsigned leaseSeconds);
+
+    /** Claim test cases that need concolic testing.
+     *
+     *  Like @ref claimConcreteTesting except it claims test cases that have concrete results but no concolic results, in
+     *  order of increasing concrete rank.
+     *
+     *  Thread safety: Not thread safe. Each thread or process should use its own database connection. */
+    std::vector<TestCaseId> claimConcolicTesting(size_t n, const std::string &worker, unsigned leaseSeconds);
+
+    /** Release a claim on a test case.
+     *
+     *  Releases the claim that @p worker has on the specified test case, if any. Workers release their claims when they've
+     *  saved the results.
+     *
+     *  Thread safety: Not thread safe. Each thread or process should use its own database connection. */
+    void releaseClaim(TestCaseId, const std::string &worker);
+
+    /** Give up on a test case.
+     *
+     *  Records @p reason as the failure of a test case claimed by @p worker and releases the claim. A failed test case is
+     *  never claimed again and doesn't count as unfinished, so a test case whose execution always throws doesn't keep the
+     *  workers retrying it forever. Does nothing if @p worker doesn't hold the claim.
+     *
+     *  Thread safety: Not thread safe. Each thread or process should use its own database connection. */
+    void failTestCase(TestCaseId, const std::string &worker, const std::string &reason);
+
+    /** Test cases that failed.
+     *
+     *  Returns the test cases given up on by @ref failTestCase, limited to the current test suite if there is one.
+     *
+     *  Thread safety: Not thread safe. */
+    std::vector<TestCaseId> failedTestCases();
+
+    /** Why a test case failed.
+     *
+     *  Returns the reason recorded by @ref failTestCase, or nothing if the test case hasn't failed.
+     *
+     *  Thread safety: Not thread safe. */
+    Sawyer::Optional<std::string> failure(TestCaseId);
+
+    /** Tests whether any test case still needs testing.
+     *
+     *  Returns true if some test case lacks concolic results and hasn't failed, regardless of whether it's claimed. Unlike
+     *  @ref hasUntested, this also accounts for test cases whose concrete results exist but whose concolic execution is still
+     *  pending or in progress, and which might therefore produce new test cases.
+     *
+     *  Thread safety: Not thread safe. */
+    bool hasUnfinished();
+#endif
+
 private:
 #if ROSE_CONCOLIC_DB_VERSION == 2
     static Ptr create(const std::string &url, const Sawyer::Optional<std::string> &testSuiteName);
@@ -1150,11 +1291,14 @@ public:
 
 private:
     Database::Ptr database_;
+    Sawyer::Stopwatch elapsed_;                         // time since construction
+    size_t nConcreteResults_;                           // number of concrete results inserted
+    size_t nConcolicResults_;                           // number of concolic results inserted
 
 protected:
     // Subclasses should implement allocating constructors
     explicit ExecutionManager(const Database::Ptr &db)
-        : database_(db) {
+        : database_(db), nConcreteResults_(0), nConcolicResults_(0) {
         ASSERT_not_null(db);
     }
 
@@ -1205,6 +1349,27 @@ public:
      *  Testing is done when there are no more test cases that need concrete or concolic results. */
     virtual bool isFinished() const;
 
+    /** Number of concrete results inserted.
+     *
+     *  This is the number of calls to @ref insertConcreteResults since this manager was created. */
+    size_t nConcreteResults() const { return nConcreteResults_; }
+
+    /** Number of concolic results inserted.
+     *
+     *  This is the number of calls to @ref insertConcolicResults since this manager was created. */
+    size_t nConcolicResults() const { return nConcolicResults_; }
+
+    /** Concrete execution throughput.
+     *
+     *  Returns the average number of concrete results inserted per second of elapsed time since this manager was created,
+     *  or zero if no time has elapsed. */
+    double concreteThroughput() const;
+
+    /** Print throughput statistics.
+     *
+     *  Prints the number of concrete and concolic results and the concrete execution rate, one item per line. */
+    void printThroughput(std::ostream&) const;
+
     /** Start running.
      *
      *  Runs concrete and concolic executors until the application is interrupted or there's nothing left to do. Subclasses
@@ -1246,6 +1411,139 @@ public:
     virtual void run() ROSE_OVERRIDE;
 };
 
+#if ROSE_CONCOLIC_DB_VERSION == 2
+/** Concolic testing of Linux executables by parallel workers.
+ *
+ *  This manager runs the concrete and concolic phases in separate worker processes that lease test cases from the database
+ *  (see @ref Database::claimConcreteTesting and @ref Database::claimConcolicTesting). The number of workers for each phase
+ *  is chosen independently, and since all coordination goes through the database, any number of managers on any number of
+ *  hosts can share one database as long as they all can reach it. Workers are processes rather than threads because the
+ *  concolic executor is not thread safe; each worker opens its own connection to the database.
+ *
+ *  Concrete workers use a @ref LinuxExecutor and concolic workers use a @ref ConcolicExecutor. Each worker keeps running
+ *  until no test case in the current test suite needs testing, or, if this manager has no workers for the other phase, until
+ *  it finds nothing to claim since then no new work can appear for it. A test case whose execution throws an exception is
+ *  recorded as failed (see @ref Database::failTestCase) and not retried, except when the exception is a transient database
+ *  error such as SQLite's "database is locked". Then the claim is released so the test case can be claimed again, up to
+ *  @ref busyRetries times. */
+class ParallelExecutionManager: public ExecutionManager {
+public:
+    /** Reference counting pointer to @ref ParallelExecutionManager. */
+    typedef Sawyer::SharedPointer<ParallelExecutionManager> Ptr;
+
+    /** Work done in one phase of testing. */
+    struct PhaseStatistics {
+        size_t nWorkers;                                /**< Number of worker processes that ran. */
+        size_t nTestCases;                              /**< Number of test cases completed by those workers. */
+        size_t nFailed;                                 /**< Number of test cases those workers gave up on. */
+        double seconds;                                 /**< Elapsed time from start to the last worker finishing. */
+
+        PhaseStatistics()
+            : nWorkers(0), nTestCases(0), nFailed(0), seconds(0.0) {}
+
+        /** Average number of test cases completed per second. */
+        double throughput() const {
+            return seconds > 0.0 ? nTestCases / seconds : 0.0;
+        }
+    };
+
+private:
+    std::string databaseUrl_;                           // so each worker can open its own connection
+    size_t nConcreteWorkers_;                           // number of concrete worker processes
+    size_t nConcolicWorkers_;                           // number of concolic worker processes
+    size_t batchSize_;                                  // number of test cases claimed at once by concrete workers
+    unsigned leaseSeconds_;                             // how long a claim lasts
+    unsigned pollMilliseconds_;                         // how long an idle worker waits before looking for more work
+    size_t busyRetries_;                                // how often a test case is retried after transient database errors
+    PhaseStatistics concreteStats_, concolicStats_;     // statistics from the latest run
+
+protected:
+    ParallelExecutionManager(const Database::Ptr&, const std::string &databaseUrl);
+
+public:
+    /** Allocating constructor.
+     *
+     *  Opens the specified existing database. If a test suite name is specified then it must exist in the database, otherwise
+     *  the latest test suite is used. The actual run is not commenced until @ref run is called. */
+    static Ptr instance(const std::string &databaseUrl, const std::string &testSuiteName = "");
+
+    /** Property: Number of concrete workers.
+     *
+     *  Number of processes that run test cases concretely. The default is the number of hardware threads.
+     *
+     * @{ */
+    size_t nConcreteWorkers() const { return nConcreteWorkers_; }
+    void nConcreteWorkers(size_t n) { nConcreteWorkers_ = n; }
+    /** @} */
+
+    /** Property: Number of concolic workers.
+     *
+     *  Number of processes that run test cases concolically. The default is one.
+     *
+     * @{ */
+    size_t nConcolicWorkers() const { return nConcolicWorkers_; }
+    void nConcolicWorkers(size_t n) { nConcolicWorkers_ = n; }
+    /** @} */
+
+    /** Property: Concrete claim size.
+     *
+     *  Number of test cases a concrete worker claims at once. Larger batches mean fewer database round trips, but the
+     *  whole batch must finish within the lease. Concolic workers always claim one test case at a time.
+     *
+     * @{ */
+    size_t batchSize() const { return batchSize_; }
+    void batchSize(size_t n) { batchSize_ = std::max(n, (size_t)1); }
+    /** @} */
+
+    /** Property: Lease duration in seconds.
+     *
+     *  A worker's claim on a test case expires after this much time, after which the test case can be claimed by another
+     *  worker. It should be longer than the longest expected concolic execution. The default is one hour.
+     *
+     * @{ */
+    unsigned leaseSeconds() const { return leaseSeconds_; }
+    void leaseSeconds(unsigned n) { leaseSeconds_ = n; }
+    /** @} */
+
+    /** Property: Idle polling interval in milliseconds.
+     *
+     *  When a worker finds nothing to claim but testing isn't finished, it waits this long before looking again.
+     *
+     * @{ */
+    unsigned pollMilliseconds() const { return pollMilliseconds_; }
+    void pollMilliseconds(unsigned n) { pollMilliseconds_ = n; }
+    /** @} */
+
+    /** Property: Retries after transient database errors.
+     *
+     *  When a worker's database operation fails because another connection holds a lock, the worker waits for the polling
+     *  interval and tries again. A test case whose processing failed this way is released and can be claimed again by
+     *  any worker, up to this many times before it is recorded as failed. The default is ten.
+     *
+     * @{ */
+    size_t busyRetries() const { return busyRetries_; }
+    void busyRetries(size_t n) { busyRetries_ = n; }
+    /** @} */
+
+    /** Statistics for the concrete phase of the latest run. */
+    const PhaseStatistics& concreteStatistics() const { return concreteStats_; }
+
+    /** Statistics for the concolic phase of the latest run. */
+    const PhaseStatistics& concolicStatistics() const { return concolicStats_; }
+
+    /** Print per-phase statistics for the latest run. */
+    void printStatistics(std::ostream&) const;
+
+    virtual void run() ROSE_OVERRIDE;
+
+private:
+    enum Phase { CONCRETE_PHASE, CONCOLIC_PHASE };
+
+    // Body of a worker process. Returns the number of test cases completed and sets nFailed to the number given up on.
+    size_t runWorker(Phase, const std::string &workerName, TestSuiteId, size_t &nFailed /*out*/);
+};
+#endif
+
 /** prints all SQL schema statements on @ref os.
  */
 void writeDBSchema(std::ostream& os);
@@ -327,6 +327,12 @@ public:
     /** Run until the next breakpoint is reached. */
     void runToBreakpoint();
 
+    /** Run until the subordinate stops.
+     *
+     *  The subordinate runs without single stepping until it receives a signal, executes a trap instruction, or terminates.
+     *  Breakpoints set with @ref setBreakpoint are ignored. */
+    void runToSignal();
+
     /** Run until the next system call.
      *
      *  The subordinate is run until it is about to make a system call or has just returned from a system call, or it has
@@ -441,6 +447,16 @@ public:
     /** Returns the last status from a call to waitpid. */
     int waitpidStatus() const { return wstat_; }
 
+    /** Property: Signal delivered when the subordinate next runs.
+     *
+     *  When the subordinate stops because of a signal other than SIGTRAP, the signal is saved and delivered to the subordinate
+     *  when it's resumed. Setting this property to zero discards the signal.
+     *
+     * @{ */
+    int pendingSignal() const { return sendSignal_; }
+    void pendingSignal(int signo) { sendSignal_ = signo; }
+    /** @} */
+
 public:
     /**  Initialize diagnostic output. This is called automatically when ROSE is initialized.  */
     static void initDiagnostics();
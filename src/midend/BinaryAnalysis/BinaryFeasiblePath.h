@@ -41,7 +41,8 @@ public:
     /** Organization of semantic memory. */
     enum SemanticMemoryParadigm {
         LIST_BASED_MEMORY,                              /**< Precise but slow. */
-        MAP_BASED_MEMORY                                /**< Fast but not precise. */
+        MAP_BASED_MEMORY,                               /**< Fast but not precise. */
+        PERSISTENT_MAP_MEMORY                           /**< Like map-based, but states share cells when copied. */
     };
 
     /** Edge visitation order. */
@@ -130,8 +131,19 @@ public:
         size_t maxCallDepthHits;                        /**< Number of times settings.maxCallDepth was hit. */
         size_t maxRecursionDepthHits;                   /**< Number of times settings.maxRecursionDepth was hit. */
 
+        // Memory used by copying semantic states when paths branch. The counts of copied and shared cells show how much
+        // memory the copies used and avoided, respectively; persistent memory states are copied without copying cells.
+        size_t nStateCopies;                            /**< Number of semantic states copied while searching. */
+        size_t nMemoryCellsCopied;                      /**< Memory cells copied along with those states. */
+        size_t nMemoryCellsShared;                      /**< Memory cells shared by those states with their originals. */
+        size_t maxMemoryCells;                          /**< Largest number of memory cells in a copied state. */
+
         Statistics()
-            : maxVertexVisitHits(0), maxPathLengthHits(0), maxCallDepthHits(0), maxRecursionDepthHits(0) {}
+            : maxVertexVisitHits(0), maxPathLengthHits(0), maxCallDepthHits(0), maxRecursionDepthHits(0), nStateCopies(0),
+              nMemoryCellsCopied(0), nMemoryCellsShared(0), maxMemoryCells(0) {}
+
+        /** Print statistics, one per line, each line starting with the specified prefix. */
+        void print(std::ostream&, const std::string &prefix = "") const;
     };
 
     /** Diagnostic output. */
@@ -684,12 +696,16 @@ private:
 
     // Mark vertex as being reached
     void markAsReached(const Partitioner2::ControlFlowGraph::ConstVertexIterator&);
+
+    // Copy a semantic state for a path that branches, and update the statistics for the memory used by the copy.
+    InstructionSemantics2::BaseSemantics::StatePtr copyState(const InstructionSemantics2::BaseSemantics::StatePtr&);
 };
 
 } // namespace
 } // namespace
 
 std::ostream& operator<<(std::ostream&, const Rose::BinaryAnalysis::FeasiblePath::Expression&);
+std::ostream& operator<<(std::ostream&, const Rose::BinaryAnalysis::FeasiblePath::Statistics&);
 
 // Convert string to feasible path expression during command-line parsing
 namespace Sawyer {
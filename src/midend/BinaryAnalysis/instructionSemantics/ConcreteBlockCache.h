@@ -0,0 +1,244 @@
+#ifndef ROSE_BinaryAnalysis_InstructionSemantics2_ConcreteBlockCache_H
+#define ROSE_BinaryAnalysis_InstructionSemantics2_ConcreteBlockCache_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include <ConcreteSemantics2.h>
+#include <DecodedInstruction.h>
+#include <DispatcherX86.h>
+#include <Sawyer/Map.h>
+
+namespace Rose {
+namespace BinaryAnalysis {
+
+class Disassembler;
+
+namespace InstructionSemantics2 {
+namespace ConcreteSemantics {
+
+/** Shared-ownership pointer to a basic block translation cache. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class BlockCache> BlockCachePtr;
+
+/** Translation cache for concrete emulation of x86 code.
+ *
+ *  Emulating with a @ref DispatcherX86 and ConcreteSemantics @ref RiscOperators is flexible but slow: every time an
+ *  instruction executes, its processor is looked up in the dispatcher and each of its operations creates new @ref SValue
+ *  objects holding bit vectors.  A block cache instead translates each basic block the first time it's executed into a short
+ *  list of micro-operations over native 64-bit integers and keeps the translation, keyed by the block's starting address, for
+ *  the next time the block executes.
+ *
+ *  Only the common integer instructions are translated: data movement (MOV, MOVZX, MOVSX, MOVSXD, LEA, PUSH, POP), the
+ *  arithmetic and logic instructions ADD, SUB, AND, OR, XOR, CMP, TEST, INC, and DEC, and control flow (JMP, Jcc, CALL, RET,
+ *  and NOP), and only when their operands are general purpose registers, constants, and memory addressed by base + index *
+ *  scale + displacement.  Every other instruction is kept as an AST and executed by the dispatcher when it's reached, in which
+ *  case the translated registers are written back to the state before, and read again after, that instruction.  Translated
+ *  instructions have the same effect on the state as the dispatcher, including the flags (undefined flags are cleared, as
+ *  in ConcreteSemantics), except that registers are written to the state only at the end of each block or before an
+ *  instruction executed by the dispatcher, and the RISC operators' per-instruction hooks are not called for translated
+ *  instructions.
+ *
+ *  Instructions are decoded from the memory of the current state, which must be a ConcreteSemantics @ref MemoryState with
+ *  little-endian byte order.  Writes to memory that contains translated code, whether by translated instructions or by
+ *  instructions executed by the dispatcher (which are watched with @ref MemoryState::watchedAddresses), cause the affected
+ *  blocks to be translated again the next time they execute, and a block that writes to its own instructions stops after the
+ *  writing instruction.  Changes made to such memory by the user are not detected; call @ref invalidate or @ref clear after
+ *  making them. */
+class BlockCache {
+public:
+    /** Counters describing the work done by a cache. */
+    struct Statistics {
+        size_t nTranslated;                             /**< Number of times a basic block was translated. */
+        size_t nExecuted;                               /**< Number of basic blocks executed. */
+        size_t nNativeInsns;                            /**< Number of instructions executed as micro-operations. */
+        size_t nFallbackInsns;                          /**< Number of instructions executed by the dispatcher. */
+
+        Statistics()
+            : nTranslated(0), nExecuted(0), nNativeInsns(0), nFallbackInsns(0) {}
+    };
+
+private:
+    // Operations performed by micro-operations. "t" denotes a temporary, "r" a register slot.
+    enum Opcode {
+        OP_GET_REG,                                     // t[dst] = bits [aux, aux+nBits) of r[a]
+        OP_PUT_REG,                                     // bits [aux, aux+nBits) of r[dst] = t[a]
+        OP_SET,                                         // t[dst] = imm
+        OP_ADDRESS,                                     // t[dst] = r[a] + r[b] * aux + imm, for optional r[a] and r[b]
+        OP_LOAD,                                        // t[dst] = nBits of memory at address t[a]
+        OP_STORE,                                       // nBits of memory at address t[a] = t[b]
+        OP_ZERO_EXTEND,                                 // t[dst] = t[a] truncated or zero extended to nBits
+        OP_SIGN_EXTEND,                                 // t[dst] = aux-bit t[a] sign extended to nBits
+        OP_ADJUST,                                      // t[dst] = t[a] + imm, without changing flags
+        OP_ADD, OP_SUB, OP_AND, OP_OR, OP_XOR,          // t[dst] = t[a] op t[b], setting flags
+        OP_INC, OP_DEC,                                 // t[dst] = t[a] +/- 1, setting flags except CF
+        OP_JUMP,                                        // next instruction is at t[a]
+        OP_JUMP_IF,                                     // next instruction is at t[a] if the condition for jump kind imm holds
+        OP_FALLBACK,                                    // execute fallbacks[imm] with the dispatcher
+        OP_EXIT_IF_MODIFIED                             // leave at exits[imm] if the block has written to its own code
+    };
+
+    // One micro-operation.
+    struct MicroOp {
+        Opcode opcode;
+        uint8_t nBits;                                  // width of the result
+        uint8_t dst;                                    // destination temporary or register slot
+        uint8_t a, b;                                   // source temporaries or register slots
+        uint8_t aux;                                    // sub-register offset, address scale, or width before extension
+        uint64_t imm;                                   // constant, displacement, jump kind, or fallback index
+
+        explicit MicroOp(Opcode opcode, size_t nBits = 0, unsigned dst = 0, unsigned a = 0, unsigned b = 0)
+            : opcode(opcode), nBits(nBits), dst(dst), a(a), b(b), aux(0), imm(0) {}
+    };
+
+    // An instruction that's executed by the dispatcher.
+    struct Fallback {
+        SgAsmInstruction *insn;                         // the instruction, owned by this cache
+        size_t nNativeBefore;                           // number of translated instructions before it in its block
+    };
+
+    // Where a block is left early when it writes to its own code.
+    struct Exit {
+        rose_addr_t va;                                 // address of the next instruction
+        size_t nNative;                                 // number of translated instructions executed so far
+    };
+
+    // A translated basic block.
+    struct Block {
+        AddressInterval extent;                         // addresses of the block's instructions
+        std::vector<MicroOp> ops;
+        std::vector<Fallback> fallbacks;
+        std::vector<Exit> exits;
+        size_t nNative;                                 // number of instructions that were translated
+
+        Block()
+            : nNative(0) {}
+    };
+
+    // Register slots. The general purpose registers are numbered by their minor numbers.
+    enum {
+        N_GPRS = 16,
+        SLOT_CF = N_GPRS, SLOT_PF, SLOT_AF, SLOT_ZF, SLOT_SF, SLOT_OF,
+        N_SLOTS,
+        NO_SLOT = 0xff
+    };
+
+    // Temporaries used by micro-operations.
+    enum { T_ADDR, T_A, T_B, T_RESULT, N_TEMPS };
+
+    typedef Sawyer::Container::Map<rose_addr_t, Block> Blocks;
+
+    DispatcherX86Ptr dispatcher_;
+    Disassembler *disassembler_;
+    RegisterDescriptor slotRegs_[N_SLOTS];              // register for each slot, or empty if the slot is not used
+    size_t gprWidth_;                                   // width of the largest general purpose registers
+    size_t addrWidth_;                                  // width of memory addresses
+    size_t maxInsnsPerBlock_;
+    Blocks blocks_;
+    AddressInterval codeHull_;                          // hull of all translated instructions
+    Statistics stats_;
+
+    // State while a block is executing
+    BaseSemantics::RiscOperators *ops_;
+    MemoryState *mem_;
+    uint64_t regs_[N_SLOTS];
+    uint32_t loaded_;                                   // slots that have been read from the state
+    uint32_t dirty_;                                    // slots that need to be written back to the state
+    uint64_t temps_[N_TEMPS];
+    AddressInterval modifiedCode_;                      // hull of writes to translated code
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    BlockCache(const DispatcherX86Ptr&, Disassembler*);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Allocating constructor.
+     *
+     *  The dispatcher must be using ConcreteSemantics RISC operators, and the disassembler is used to decode the instructions
+     *  from the dispatcher's current memory state. The disassembler is not owned by the cache. */
+    static BlockCachePtr instance(const DispatcherX86Ptr &dispatcher, Disassembler *disassembler) {
+        return BlockCachePtr(new BlockCache(dispatcher, disassembler));
+    }
+
+    ~BlockCache();
+
+private:
+    BlockCache(const BlockCache&);                      // not copyable
+    BlockCache& operator=(const BlockCache&);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods first declared in this class
+public:
+    /** Dispatcher that executes instructions that are not translated. */
+    DispatcherX86Ptr dispatcher() const { return dispatcher_; }
+
+    /** Maximum number of instructions per translated block.
+     *
+     *  A block ends at the first instruction that terminates a basic block, at the first address that can't be decoded, or
+     *  after this many instructions, whichever comes first. Changing the limit affects only blocks translated afterward.
+     *
+     * @{ */
+    size_t maxInsnsPerBlock() const { return maxInsnsPerBlock_; }
+    void maxInsnsPerBlock(size_t n) { maxInsnsPerBlock_ = std::max(n, (size_t)1); }
+    /** @} */
+
+    /** Execute one basic block.
+     *
+     *  Executes the block that starts at the current instruction pointer, translating it first if necessary, and returns the
+     *  new value of the instruction pointer.  Throws a @ref Disassembler::Exception if no instruction can be decoded at the
+     *  instruction pointer, and passes along any exception thrown by the dispatcher. */
+    rose_addr_t executeBlock();
+
+    /** Discard translations of blocks that overlap the specified addresses. */
+    void invalidate(const AddressInterval&);
+
+    /** Discard all translations. */
+    void clear();
+
+    /** Number of translated blocks in the cache. */
+    size_t size() const { return blocks_.size(); }
+
+    /** Counters describing the work done so far.
+     *
+     * @{ */
+    const Statistics& statistics() const { return stats_; }
+    void resetStatistics() { stats_ = Statistics(); }
+    /** @} */
+
+protected:
+    // Translate the block that starts at the specified address.
+    Block& translate(rose_addr_t va, const MemoryMap::Ptr&);
+
+    // Append micro-operations that perform an instruction, or return false if the instruction is not supported.
+    bool lower(SgAsmX86Instruction*, const DecodedInstruction&, std::vector<MicroOp>&);
+
+    // Helpers for lower
+    unsigned gprSlot(RegisterDescriptor) const;
+    bool lowerAddress(const DecodedOperand&, const DecodedInstruction&, unsigned dst, std::vector<MicroOp>&);
+    bool lowerRead(const DecodedOperand&, const DecodedInstruction&, unsigned dst, std::vector<MicroOp>&);
+    bool lowerWrite(const DecodedOperand&, const DecodedInstruction&, unsigned src, std::vector<MicroOp>&);
+
+    // Execute a translated block and return the address of the next instruction.
+    rose_addr_t execute(Block&);
+
+    // Register slot access while executing.
+    uint64_t readSlot(unsigned slot);
+    void writeSlot(unsigned slot, uint64_t value);
+    void flushSlots();
+
+    // Memory access while executing.
+    uint64_t readMemory(rose_addr_t va, size_t nBytes);
+    void writeMemory(rose_addr_t va, size_t nBytes, uint64_t value);
+
+    // Delete the ASTs owned by a block.
+    static void deleteBlock(Block&);
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#endif
+#endif
@@ -169,6 +169,8 @@ typedef boost::shared_ptr<class MemoryState> MemoryStatePtr;
 class MemoryState: public BaseSemantics::MemoryState {
     MemoryMap::Ptr map_;
     rose_addr_t pageSize_;
+    AddressInterval watched_;                           // addresses whose writes are recorded
+    AddressInterval watchedWrites_;                     // hull of recorded writes
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Real constructors
@@ -296,6 +298,24 @@ public:
      *  is already allocated unless: it will replace the allocated page with a new one containing all zeros. */
     void allocatePage(rose_addr_t va);
 
+    /** Addresses watched for writes.
+     *
+     *  Each byte written by @ref writeMemory to a watched address is added to the @ref watchedWrites hull. Nothing is watched
+     *  by default, and copies of this state watch nothing.
+     *
+     * @{ */
+    const AddressInterval& watchedAddresses() const { return watched_; }
+    void watchedAddresses(const AddressInterval &where) { watched_ = where; }
+    /** @} */
+
+    /** Hull of the watched addresses that have been written.
+     *
+     *  This accumulates until it's reset by the caller.
+     *
+     * @{ */
+    const AddressInterval& watchedWrites() const { return watchedWrites_; }
+    void watchedWrites(const AddressInterval &where) { watchedWrites_ = where; }
+    /** @} */
 };
 
 
@@ -0,0 +1,574 @@
+#ifndef Rose_LaneSemantics2_H
+#define Rose_LaneSemantics2_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include "BaseSemantics2.h"
+#include "ConcreteSemantics2.h"
+#include "RegisterStateGeneric.h"
+#include <Sawyer/BitVector.h>
+#include <Sawyer/Map.h>
+
+namespace Rose {
+namespace BinaryAnalysis {              // documented elsewhere
+namespace InstructionSemantics2 {       // documented elsewhere
+
+/** A concrete semantic domain that executes many inputs at once.
+ *
+ *  Each value in this domain is a vector of concrete values, one per "lane", and each lane is an independent execution of the
+ *  same instructions on different inputs.  A single call to a dispatcher's @c processInstruction therefore executes the
+ *  instruction for all lanes, and each RISC operation is a loop over the lanes. Values are stored lane-contiguously so that
+ *  those loops can be vectorized by the compiler.
+ *
+ *  The lanes diverge when a conditional branch goes different ways for different inputs. The @ref
+ *  RiscOperators::maskDivergentLanes "maskDivergentLanes" method deactivates the lanes that are not at the same instruction
+ *  as the first active lane, and writes to registers and memory do not change inactive lanes. The caller decides when to run
+ *  the inactive lanes by activating them again, and can obtain a @ref ConcreteSemantics state for any lane with @ref
+ *  RiscOperators::laneState "laneState".
+ *
+ *  Values that are at most 64 bits wide are computed directly by this domain. Wider values, and operations such as
+ *  floating-point that this domain doesn't implement directly, are computed one lane at a time by the @ref ConcreteSemantics
+ *  domain and therefore have the same capabilities and limitations. */
+namespace LaneSemantics {
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Value type
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Smart-ownership pointer to a lane semantic value. See @ref heap_object_shared_ownership. */
+typedef Sawyer::SharedPointer<class SValue> SValuePtr;
+
+/** Formatter for lane values. */
+typedef BaseSemantics::Formatter Formatter;
+
+/** Type of values manipulated by the lane domain.
+ *
+ *  Each value has a width and a concrete value for each lane.  All values created from the same prototypical value have the
+ *  same number of lanes.  Like @ref ConcreteSemantics, this domain cannot represent undefined values, and any attempt to
+ *  create one creates a value whose lanes are all zero instead. */
+class SValue: public BaseSemantics::SValue {
+protected:
+    size_t nLanes_;
+    std::vector<uint64_t> words_;                       // word w of lane i is words_[w*nLanes_+i]; unused high bits are clear
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    SValue(size_t nLanes, size_t nbits)
+        : BaseSemantics::SValue(nbits), nLanes_(nLanes), words_(nLanes * nWords(nbits), 0) {
+        ASSERT_require(nLanes > 0);
+    }
+
+    SValue(size_t nLanes, size_t nbits, uint64_t number);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Instantiate a new prototypical value having the specified number of lanes. Prototypical values are only used for their
+     *  virtual constructors. */
+    static SValuePtr instance(size_t nLanes) {
+        return SValuePtr(new SValue(nLanes, 1));
+    }
+
+    /** Instantiate a new value whose lanes are all zero. */
+    static SValuePtr instance(size_t nLanes, size_t nbits) {
+        return SValuePtr(new SValue(nLanes, nbits));
+    }
+
+    /** Instantiate a new value having the same concrete value in each lane. */
+    static SValuePtr instance(size_t nLanes, size_t nbits, uint64_t value) {
+        return SValuePtr(new SValue(nLanes, nbits, value));
+    }
+
+    /** Instantiate a new value having a different concrete value in each lane. The number of lanes is the size of the
+     *  vector. The width must not be more than 64 bits; use @ref laneBits to initialize wider values. */
+    static SValuePtr instance(size_t nbits, const std::vector<uint64_t> &laneValues);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Virtual allocating constructors
+public:
+    virtual BaseSemantics::SValuePtr undefined_(size_t nbits) const ROSE_OVERRIDE {
+        return instance(nLanes_, nbits);
+    }
+    virtual BaseSemantics::SValuePtr unspecified_(size_t nbits) const ROSE_OVERRIDE {
+        return instance(nLanes_, nbits);
+    }
+    virtual BaseSemantics::SValuePtr bottom_(size_t nbits) const ROSE_OVERRIDE {
+        return instance(nLanes_, nbits);
+    }
+    virtual BaseSemantics::SValuePtr number_(size_t nbits, uint64_t value) const ROSE_OVERRIDE {
+        return instance(nLanes_, nbits, value);
+    }
+    virtual BaseSemantics::SValuePtr boolean_(bool value) const ROSE_OVERRIDE {
+        return instance(nLanes_, 1, value ? 1 : 0);
+    }
+    virtual BaseSemantics::SValuePtr copy(size_t new_width=0) const ROSE_OVERRIDE {
+        SValuePtr retval(new SValue(*this));
+        if (new_width!=0 && new_width!=retval->get_width())
+            retval->set_width(new_width);
+        return retval;
+    }
+    virtual Sawyer::Optional<BaseSemantics::SValuePtr>
+    createOptionalMerge(const BaseSemantics::SValuePtr &other, const BaseSemantics::MergerPtr&,
+                        const SmtSolverPtr&) const ROSE_OVERRIDE;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Dynamic pointer casts
+public:
+    /** Promote a base value to a LaneSemantics value.  The value @p v must have a LaneSemantics::SValue dynamic type. */
+    static SValuePtr promote(const BaseSemantics::SValuePtr &v) { // hot
+        SValuePtr retval = v.dynamicCast<SValue>();
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Override virtual methods...
+public:
+    virtual bool may_equal(const BaseSemantics::SValuePtr &other,
+                           const SmtSolverPtr &solver = SmtSolverPtr()) const ROSE_OVERRIDE;
+    virtual bool must_equal(const BaseSemantics::SValuePtr &other,
+                            const SmtSolverPtr &solver = SmtSolverPtr()) const ROSE_OVERRIDE;
+
+    virtual void set_width(size_t nbits) ROSE_OVERRIDE;
+
+    virtual bool isBottom() const ROSE_OVERRIDE {
+        return false;
+    }
+
+    /** A value is a number only if all its lanes are equal. */
+    virtual bool is_number() const ROSE_OVERRIDE {
+        return isUniform();
+    }
+
+    /** The value of the first lane. */
+    virtual uint64_t get_number() const ROSE_OVERRIDE;
+
+    virtual void print(std::ostream&, BaseSemantics::Formatter&) const ROSE_OVERRIDE;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Additional methods first declared in this class...
+public:
+    /** Number of 64-bit words needed to store one lane of a value having the specified width. */
+    static size_t nWords(size_t nbits) {
+        return (nbits + 63) / 64;
+    }
+
+    /** Number of lanes. */
+    size_t nLanes() const { return nLanes_; }
+
+    /** Whether all lanes have the same value. */
+    bool isUniform() const;
+
+    /** Value of one lane.
+     *
+     *  Values wider than 64 bits return or set only the low-order 64 bits, and setting the value clears the other bits.
+     *
+     * @{ */
+    uint64_t lane(size_t i) const {
+        ASSERT_require(i < nLanes_);
+        return words_[i];
+    }
+    void lane(size_t i, uint64_t value);
+    /** @} */
+
+    /** Bits of one lane.
+     *
+     *  These work for values of any width.
+     *
+     * @{ */
+    Sawyer::Container::BitVector laneBits(size_t i) const;
+    void laneBits(size_t i, const Sawyer::Container::BitVector&);
+    /** @} */
+
+    /** One word of every lane.
+     *
+     *  Returns a pointer to an array with one element per lane, containing the specified 64-bit word of each lane, least
+     *  significant word first.  This is the storage operated on by the RISC operators.
+     *
+     * @{ */
+    const uint64_t* words(size_t word = 0) const {
+        ASSERT_require(word < nWords(get_width()));
+        return &words_[word * nLanes_];
+    }
+    uint64_t* words(size_t word = 0) {
+        ASSERT_require(word < nWords(get_width()));
+        return &words_[word * nLanes_];
+    }
+    /** @} */
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Register State
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef BaseSemantics::RegisterStateGeneric RegisterState;
+typedef BaseSemantics::RegisterStateGenericPtr RegisterStatePtr;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Memory State
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Shared-ownership pointer to a lane memory state. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class MemoryState> MemoryStatePtr;
+
+/** Byte-addressable memory having one address space per lane.
+ *
+ *  The bytes written by each lane are stored separately for each lane. Bytes that a lane has not written are read from an
+ *  optional initial memory map that's shared by all lanes and never modified, such as a map containing the specimen.  Bytes
+ *  that are in neither are read as the default value supplied by the caller. */
+class MemoryState: public BaseSemantics::MemoryState {
+public:
+    /** Bytes written by one lane, indexed by address. */
+    typedef Sawyer::Container::Map<rose_addr_t, uint8_t> LaneBytes;
+
+private:
+    std::vector<LaneBytes> lanes_;
+    MemoryMap::Ptr initialMemory_;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    MemoryState(const BaseSemantics::SValuePtr &addrProtoval, const BaseSemantics::SValuePtr &valProtoval)
+        : BaseSemantics::MemoryState(addrProtoval, valProtoval), lanes_(SValue::promote(valProtoval)->nLanes()) {
+        (void) SValue::promote(addrProtoval);           // for its checking side effects
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Instantiates a new memory state having specified prototypical values.
+     *
+     *  The @p addrProtoval and @p valProtoval must both be of LaneSemantics::SValue type or derived classes, and the number of
+     *  lanes is the number of lanes in @p valProtoval. */
+    static MemoryStatePtr instance(const BaseSemantics::SValuePtr &addrProtoval, const BaseSemantics::SValuePtr &valProtoval) {
+        return MemoryStatePtr(new MemoryState(addrProtoval, valProtoval));
+    }
+
+    /** Instantiates a new deep copy of an existing state. The initial memory map is shared since it's never modified. */
+    static MemoryStatePtr instance(const MemoryStatePtr &other) {
+        return MemoryStatePtr(new MemoryState(*other));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Virtual constructors
+public:
+    virtual BaseSemantics::MemoryStatePtr create(const BaseSemantics::SValuePtr &addrProtoval,
+                                                 const BaseSemantics::SValuePtr &valProtoval) const ROSE_OVERRIDE {
+        return instance(addrProtoval, valProtoval);
+    }
+
+    virtual BaseSemantics::MemoryStatePtr clone() const ROSE_OVERRIDE {
+        return MemoryStatePtr(new MemoryState(*this));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Dynamic pointer casts
+public:
+    /** Recasts a base pointer to a lane memory state. This is a checked cast that will fail if the specified pointer does not
+     *  have a run-time type that is a LaneSemantics::MemoryState or subclass thereof. */
+    static MemoryStatePtr promote(const BaseSemantics::MemoryStatePtr &x) {
+        MemoryStatePtr retval = boost::dynamic_pointer_cast<MemoryState>(x);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods we inherited
+public:
+    /** Erase the bytes written by all lanes. The initial memory is not affected. */
+    virtual void clear() ROSE_OVERRIDE;
+
+    virtual void print(std::ostream&, Formatter&) const ROSE_OVERRIDE;
+
+    virtual BaseSemantics::SValuePtr readMemory(const BaseSemantics::SValuePtr &addr, const BaseSemantics::SValuePtr &dflt,
+                                                BaseSemantics::RiscOperators *addrOps,
+                                                BaseSemantics::RiscOperators *valOps) ROSE_OVERRIDE;
+
+    virtual BaseSemantics::SValuePtr peekMemory(const BaseSemantics::SValuePtr &addr, const BaseSemantics::SValuePtr &dflt,
+                                                BaseSemantics::RiscOperators *addrOps,
+                                                BaseSemantics::RiscOperators *valOps) ROSE_OVERRIDE;
+
+    virtual void writeMemory(const BaseSemantics::SValuePtr &addr, const BaseSemantics::SValuePtr &value,
+                             BaseSemantics::RiscOperators *addrOps, BaseSemantics::RiscOperators *valOps) ROSE_OVERRIDE;
+
+    virtual bool merge(const BaseSemantics::MemoryStatePtr &other, BaseSemantics::RiscOperators *addrOps,
+                       BaseSemantics::RiscOperators *valOps) ROSE_OVERRIDE;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods first declared in this class
+public:
+    /** Number of lanes. */
+    size_t nLanes() const { return lanes_.size(); }
+
+    /** Memory shared by all lanes.
+     *
+     *  Bytes that a lane hasn't written are read from this map if they're present. The map is never modified by this state.
+     *
+     * @{ */
+    MemoryMap::Ptr initialMemory() const { return initialMemory_; }
+    void initialMemory(const MemoryMap::Ptr &map) { initialMemory_ = map; }
+    /** @} */
+
+    /** Bytes written by one lane.
+     *
+     *  The returned map can be modified in order to give a lane different memory inputs than the other lanes.
+     *
+     * @{ */
+    const LaneBytes& laneBytes(size_t lane) const {
+        ASSERT_require(lane < lanes_.size());
+        return lanes_[lane];
+    }
+    LaneBytes& laneBytes(size_t lane) {
+        ASSERT_require(lane < lanes_.size());
+        return lanes_[lane];
+    }
+    /** @} */
+};
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Complete semantic state
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+typedef BaseSemantics::State State;
+typedef BaseSemantics::StatePtr StatePtr;
+
+
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      RISC operators
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Shared-ownership pointer to lane RISC operations. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class RiscOperators> RiscOperatorsPtr;
+
+/** Defines RISC operators for the LaneSemantics domain.
+ *
+ *  These RISC operators depend on functionality introduced into the SValue class hierarchy at the LaneSemantics::SValue level.
+ *  Therefore, the prototypical value supplied to the constructor or present in the supplied state object must have a dynamic
+ *  type which is a LaneSemantics::SValue (or subclass), and its number of lanes is the number of lanes for all values.
+ *
+ *  Each lane is either active or inactive. All lanes are computed by every operation, but writes to registers and memory change
+ *  only the active lanes. */
+class RiscOperators: public BaseSemantics::RiscOperators {
+    std::vector<bool> activeLanes_;                     // lanes that are changed by writes to registers and memory
+    SValuePtr activeMask_;                              // activeLanes_ as a Boolean value, or null if all are active
+    ConcreteSemantics::RiscOperatorsPtr concrete_;      // for computing lanes of values this domain doesn't compute directly
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    RiscOperators(const BaseSemantics::SValuePtr &protoval, const SmtSolverPtr &solver)
+        : BaseSemantics::RiscOperators(protoval, solver), activeLanes_(SValue::promote(protoval)->nLanes(), true),
+          concrete_(ConcreteSemantics::RiscOperators::instance(ConcreteSemantics::SValue::instance())) {
+        name("Lane");
+    }
+
+    RiscOperators(const BaseSemantics::StatePtr &state, const SmtSolverPtr &solver)
+        : BaseSemantics::RiscOperators(state, solver), activeLanes_(SValue::promote(state->protoval())->nLanes(), true),
+          concrete_(ConcreteSemantics::RiscOperators::instance(ConcreteSemantics::SValue::instance())) {
+        name("Lane");
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Instantiates a new @ref RiscOperators object and configures it to use semantic values and states that are defaults for
+     *  @ref LaneSemantics with the specified number of lanes. */
+    static RiscOperatorsPtr instance(const RegisterDictionary *regdict, size_t nLanes,
+                                     const SmtSolverPtr &solver = SmtSolverPtr()) {
+        BaseSemantics::SValuePtr protoval = SValue::instance(nLanes);
+        BaseSemantics::RegisterStatePtr registers = RegisterState::instance(protoval, regdict);
+        BaseSemantics::MemoryStatePtr memory = MemoryState::instance(protoval, protoval);
+        BaseSemantics::StatePtr state = State::instance(registers, memory);
+        return RiscOperatorsPtr(new RiscOperators(state, solver));
+    }
+
+    /** Instantiates a new @ref RiscOperators object with specified prototypical values.  An SMT solver may be specified as the
+     *  second argument because the base class expects one, but it is not used for @ref LaneSemantics. */
+    static RiscOperatorsPtr instance(const BaseSemantics::SValuePtr &protoval, const SmtSolverPtr &solver = SmtSolverPtr()) {
+        return RiscOperatorsPtr(new RiscOperators(protoval, solver));
+    }
+
+    /** Instantiates a new RiscOperators object with specified state.  An SMT solver may be specified as the second argument
+     *  because the base class expects one, but it is not used for @ref LaneSemantics. */
+    static RiscOperatorsPtr instance(const BaseSemantics::StatePtr &state, const SmtSolverPtr &solver = SmtSolverPtr()) {
+        return RiscOperatorsPtr(new RiscOperators(state, solver));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Virtual constructors
+public:
+    virtual BaseSemantics::RiscOperatorsPtr create(const BaseSemantics::SValuePtr &protoval,
+                                                   const SmtSolverPtr &solver = SmtSolverPtr()) const ROSE_OVERRIDE {
+        return instance(protoval, solver);
+    }
+
+    virtual BaseSemantics::RiscOperatorsPtr create(const BaseSemantics::StatePtr &state,
+                                                   const SmtSolverPtr &solver = SmtSolverPtr()) const ROSE_OVERRIDE {
+        return instance(state, solver);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Dynamic pointer casts
+public:
+    /** Run-time promotion of a base RiscOperators pointer to lane operators. This is a checked conversion--it will fail if @p x
+     *  does not point to a LaneSemantics::RiscOperators object. */
+    static RiscOperatorsPtr promote(const BaseSemantics::RiscOperatorsPtr &x) {
+        RiscOperatorsPtr retval = boost::dynamic_pointer_cast<RiscOperators>(x);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Lanes
+public:
+    /** Number of lanes. */
+    size_t nLanes() const {
+        return activeLanes_.size();
+    }
+
+    /** Lanes that are changed by writes.
+     *
+     *  The vector has one element per lane, which is true if the lane is active.
+     *
+     * @{ */
+    const std::vector<bool>& activeLanes() const { return activeLanes_; }
+    void activeLanes(const std::vector<bool>&);
+    /** @} */
+
+    /** Activate all lanes. */
+    void activateAllLanes();
+
+    /** Number of active lanes. */
+    size_t nActiveLanes() const;
+
+    /** Deactivate lanes whose instruction pointer differs from the first active lane's.
+     *
+     *  The @p ip is normally the value of the instruction pointer register after an instruction is processed. All active lanes
+     *  whose @p ip lane is different than the first active lane's are deactivated, and the return value is the number of lanes
+     *  that were deactivated. */
+    size_t maskDivergentLanes(const BaseSemantics::SValuePtr &ip);
+
+    /** Concrete state for one lane.
+     *
+     *  Returns a new @ref ConcreteSemantics state whose registers and memory have the values of the specified lane of the
+     *  current state. The returned memory contains the initial memory (copy-on-write) plus the bytes written by that lane. */
+    BaseSemantics::StatePtr laneState(size_t lane);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // New methods for constructing values, so we don't have to write so many SValue::promote calls in the RiscOperators
+    // implementations.
+protected:
+    SValuePtr svalue_zero(size_t nbits) {
+        return SValue::instance(nLanes(), nbits);
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Override methods from base class.  These are the RISC operators that are invoked by a Dispatcher.
+public:
+    virtual BaseSemantics::SValuePtr and_(const BaseSemantics::SValuePtr &a_,
+                                          const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr or_(const BaseSemantics::SValuePtr &a_,
+                                         const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr xor_(const BaseSemantics::SValuePtr &a_,
+                                          const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr invert(const BaseSemantics::SValuePtr &a_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr extract(const BaseSemantics::SValuePtr &a_,
+                                             size_t begin_bit, size_t end_bit) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr concat(const BaseSemantics::SValuePtr &a_,
+                                            const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr leastSignificantSetBit(const BaseSemantics::SValuePtr &a_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr mostSignificantSetBit(const BaseSemantics::SValuePtr &a_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr rotateLeft(const BaseSemantics::SValuePtr &a_,
+                                                const BaseSemantics::SValuePtr &sa_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr rotateRight(const BaseSemantics::SValuePtr &a_,
+                                                 const BaseSemantics::SValuePtr &sa_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr shiftLeft(const BaseSemantics::SValuePtr &a_,
+                                               const BaseSemantics::SValuePtr &sa_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr shiftRight(const BaseSemantics::SValuePtr &a_,
+                                                const BaseSemantics::SValuePtr &sa_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr shiftRightArithmetic(const BaseSemantics::SValuePtr &a_,
+                                                          const BaseSemantics::SValuePtr &sa_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr equalToZero(const BaseSemantics::SValuePtr &a_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr ite(const BaseSemantics::SValuePtr &sel_,
+                                         const BaseSemantics::SValuePtr &a_,
+                                         const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr unsignedExtend(const BaseSemantics::SValuePtr &a_, size_t new_width) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr signExtend(const BaseSemantics::SValuePtr &a_, size_t new_width) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr add(const BaseSemantics::SValuePtr &a_,
+                                         const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr addWithCarries(const BaseSemantics::SValuePtr &a_,
+                                                    const BaseSemantics::SValuePtr &b_,
+                                                    const BaseSemantics::SValuePtr &c_,
+                                                    BaseSemantics::SValuePtr &carry_out/*out*/) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr negate(const BaseSemantics::SValuePtr &a_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr signedDivide(const BaseSemantics::SValuePtr &a_,
+                                                  const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr signedModulo(const BaseSemantics::SValuePtr &a_,
+                                                  const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr signedMultiply(const BaseSemantics::SValuePtr &a_,
+                                                    const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr unsignedDivide(const BaseSemantics::SValuePtr &a_,
+                                                    const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr unsignedModulo(const BaseSemantics::SValuePtr &a_,
+                                                    const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr unsignedMultiply(const BaseSemantics::SValuePtr &a_,
+                                                      const BaseSemantics::SValuePtr &b_) ROSE_OVERRIDE;
+
+    virtual BaseSemantics::SValuePtr fpFromInteger(const BaseSemantics::SValuePtr &intValue, SgAsmFloatType*) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr fpToInteger(const BaseSemantics::SValuePtr &fpValue, SgAsmFloatType *fpType,
+                                                 const BaseSemantics::SValuePtr &dflt) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr fpAdd(const BaseSemantics::SValuePtr &a, const BaseSemantics::SValuePtr &b,
+                                           SgAsmFloatType*) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr fpSubtract(const BaseSemantics::SValuePtr &a, const BaseSemantics::SValuePtr &b,
+                                                SgAsmFloatType*) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr fpMultiply(const BaseSemantics::SValuePtr &a, const BaseSemantics::SValuePtr &b,
+                                                SgAsmFloatType*) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr fpRoundTowardZero(const BaseSemantics::SValuePtr &a, SgAsmFloatType*) ROSE_OVERRIDE;
+
+    virtual void writeRegister(RegisterDescriptor reg, const BaseSemantics::SValuePtr &a) ROSE_OVERRIDE;
+
+    virtual BaseSemantics::SValuePtr readMemory(RegisterDescriptor segreg,
+                                                const BaseSemantics::SValuePtr &addr,
+                                                const BaseSemantics::SValuePtr &dflt,
+                                                const BaseSemantics::SValuePtr &cond) ROSE_OVERRIDE;
+    virtual BaseSemantics::SValuePtr peekMemory(RegisterDescriptor segreg,
+                                                const BaseSemantics::SValuePtr &addr,
+                                                const BaseSemantics::SValuePtr &dflt) ROSE_OVERRIDE;
+    virtual void writeMemory(RegisterDescriptor segreg,
+                             const BaseSemantics::SValuePtr &addr,
+                             const BaseSemantics::SValuePtr &data,
+                             const BaseSemantics::SValuePtr &cond) ROSE_OVERRIDE;
+
+protected:
+    // handles readMemory and peekMemory
+    BaseSemantics::SValuePtr readOrPeekMemory(RegisterDescriptor segreg, const BaseSemantics::SValuePtr &address,
+                                              const BaseSemantics::SValuePtr &dflt, bool allowSideEffects);
+
+    // Lane of a value as a concrete value, and a concrete value stored into a lane
+    BaseSemantics::SValuePtr concreteLane(const BaseSemantics::SValuePtr&, size_t lane);
+    void concreteLane(const SValuePtr &result, size_t lane, const BaseSemantics::SValuePtr &concreteValue);
+
+    // Compute each active lane with the concrete domain. Inactive lanes of the result are zero.
+    typedef BaseSemantics::SValuePtr (BaseSemantics::RiscOperators::*UnaryOperator)(const BaseSemantics::SValuePtr&);
+    typedef BaseSemantics::SValuePtr (BaseSemantics::RiscOperators::*BinaryOperator)(const BaseSemantics::SValuePtr&,
+                                                                                       const BaseSemantics::SValuePtr&);
+    SValuePtr concreteEachLane(size_t resultWidth, UnaryOperator, const BaseSemantics::SValuePtr &a);
+    SValuePtr concreteEachLane(size_t resultWidth, BinaryOperator, const BaseSemantics::SValuePtr &a,
+                               const BaseSemantics::SValuePtr &b);
+
+    // Whether all lanes of a Boolean value are true or false
+    bool allTrue(const SValuePtr&) const;
+    bool allFalse(const SValuePtr&) const;
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#endif
+#endif
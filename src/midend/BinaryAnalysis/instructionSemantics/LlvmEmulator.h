@@ -0,0 +1,194 @@
+#ifndef ROSE_BinaryAnalysis_InstructionSemantics2_LlvmEmulator_H
+#define ROSE_BinaryAnalysis_InstructionSemantics2_LlvmEmulator_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include <MemoryMap.h>
+#include <Registers.h>
+#include <RoseException.h>
+#include <Sawyer/Map.h>
+#include <Sawyer/Optional.h>
+#include <boost/filesystem.hpp>
+
+namespace Rose {
+namespace BinaryAnalysis {
+namespace InstructionSemantics2 {
+namespace LlvmSemantics {
+
+/** Exceptions thrown when compiling or running emulation code. */
+class EmulatorException: public Rose::Exception {
+public:
+    /** Construct an exception with a message. */
+    explicit EmulatorException(const std::string &mesg)
+        : Rose::Exception(mesg) {}
+
+    /** Destructor. */
+    ~EmulatorException() throw () {}
+};
+
+/** Compiles LLVM assembly to a shared object.
+ *
+ *  The LLVM assembly is usually produced by a @ref Transcoder in emulation mode, and the shared object is loaded by an @ref
+ *  Emulator. Compiling is done by running a command, the local LLVM toolchain by default. */
+class Compiler {
+    std::string command_;
+    bool keepFiles_;
+
+public:
+    /** Construct a compiler with the default command. */
+    Compiler();
+
+    /** Property: Compile command.
+     *
+     *  The command that compiles LLVM assembly to a shared object. It's run by the shell after replacing "%o" with the name of
+     *  the shared object and "%f" with the name of the LLVM assembly file, both quoted for the shell. The default is "clang
+     *  -O2 -shared -fPIC -Wno-override-module -o %o %f".
+     *
+     * @{ */
+    const std::string& command() const { return command_; }
+    void command(const std::string &s) { command_ = s; }
+    /** @} */
+
+    /** Property: Keep temporary files.
+     *
+     *  If set, the temporary LLVM assembly file written by @ref compile is not deleted, which is useful when the LLVM needs to
+     *  be inspected because it doesn't compile.
+     *
+     * @{ */
+    bool keepFiles() const { return keepFiles_; }
+    void keepFiles(bool b) { keepFiles_ = b; }
+    /** @} */
+
+    /** Compile LLVM assembly to a shared object.
+     *
+     *  Compiles LLVM assembly contained in a string, or in the named file, to the named shared object. Throws an @ref
+     *  EmulatorException containing the command's output if the command fails.
+     *
+     * @{ */
+    void compile(const std::string &llvmAssembly, const boost::filesystem::path &sharedObject) const;
+    void compileFile(const boost::filesystem::path &llvmFile, const boost::filesystem::path &sharedObject) const;
+    /** @} */
+};
+
+/** Shared-ownership pointer to an emulator. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class Emulator> EmulatorPtr;
+
+/** Runs compiled emulation code.
+ *
+ *  An emulator loads a shared object compiled from the LLVM that a @ref Transcoder emits in emulation mode, and calls its
+ *  functions by their entry addresses in the specimen. The machine registers are global variables in the shared object and
+ *  can be read and written between calls, and memory is read from and written to a @ref MemoryMap supplied by the caller,
+ *  including the stack, which must therefore be mapped.
+ *
+ *  A call returns when the specimen's function returns, or when the emulation code reaches an instruction it can't execute:
+ *  an instruction without semantics, or a branch to an address that isn't in a compiled function. In either case the
+ *  instruction pointer register holds the address of the next instruction, so the caller can continue some other way, such
+ *  as with a dispatcher. A memory access that is outside the map or doesn't have the needed access permission is a fault:
+ *  the call returns right away with the instruction pointer register holding the address of the faulting instruction and
+ *  the registers as they were before that instruction, and @ref fault returns the address that couldn't be accessed. An
+ *  instruction that writes more than one memory location might have completed some of its writes before faulting. There is
+ *  no limit on the number of instructions executed by a call.
+ *
+ *  The emulated machine must be little endian, and only registers up to 64 bits wide can be accessed. */
+class Emulator {
+public:
+    /** Type of the functions in the shared object. */
+    typedef void (*Function)();
+
+private:
+    typedef Sawyer::Container::Map<rose_addr_t, Function> Functions;
+    typedef uint64_t (*MemoryRead)(void*, uint64_t, uint32_t);
+    typedef void (*MemoryWrite)(void*, uint64_t, uint32_t, uint64_t);
+
+    void *handle_;                                      // from dlopen
+    const RegisterDictionary *regdict_;
+    MemoryMap::Ptr memory_;
+    Functions functions_;
+    Sawyer::Optional<rose_addr_t> fault_;               // first faulting address during the most recent call
+
+    // Globals defined by the shared object
+    uint8_t *exit_;
+    void **context_;
+    MemoryRead *memoryRead_;
+    MemoryWrite *memoryWrite_;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    Emulator(const boost::filesystem::path &sharedObject, const RegisterDictionary*, const MemoryMap::Ptr&);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Allocating constructor.
+     *
+     *  Loads the shared object, which must have been compiled from the LLVM emitted by a transcoder in emulation mode using
+     *  the specified register dictionary. Throws an @ref EmulatorException if the shared object can't be loaded or is missing
+     *  parts of the emulation interface. */
+    static EmulatorPtr instance(const boost::filesystem::path &sharedObject, const RegisterDictionary *regdict,
+                                const MemoryMap::Ptr &memory) {
+        return EmulatorPtr(new Emulator(sharedObject, regdict, memory));
+    }
+
+    /** Destructor unloads the shared object. */
+    ~Emulator();
+
+private:
+    Emulator(const Emulator&);                          // not copyable
+    Emulator& operator=(const Emulator&);
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods first declared in this class
+public:
+    /** Property: Memory read and written by the emulation code.
+     *
+     * @{ */
+    MemoryMap::Ptr memoryMap() const { return memory_; }
+    void memoryMap(const MemoryMap::Ptr &map) { memory_ = map; }
+    /** @} */
+
+    /** Entry addresses of the compiled functions. */
+    std::vector<rose_addr_t> functionAddresses() const;
+
+    /** Whether a function is compiled for the specified entry address. */
+    bool hasFunction(rose_addr_t entryVa) const { return functions_.exists(entryVa); }
+
+    /** Read or write a register.
+     *
+     *  The register must be one that the transcoder emitted, and no wider than 64 bits. Throws an @ref EmulatorException
+     *  otherwise.
+     *
+     * @{ */
+    uint64_t readRegister(RegisterDescriptor) const;
+    void writeRegister(RegisterDescriptor, uint64_t value);
+    /** @} */
+
+    /** Call a compiled function.
+     *
+     *  Runs the function whose entry address is specified, ignoring the current value of the instruction pointer register.
+     *  Returns true if the function returned normally, or false if the emulation code stopped early or a memory access
+     *  faulted. Throws an @ref EmulatorException if no function is compiled for the address. */
+    bool call(rose_addr_t entryVa);
+
+    /** Address of the first memory access that faulted during the most recent call, if any. */
+    const Sawyer::Optional<rose_addr_t>& fault() const { return fault_; }
+
+protected:
+    // Address of a global variable in the shared object, or null if it doesn't exist.
+    void* findSymbol(const std::string &name) const;
+
+    // Address of a register's global variable. Throws if there is none or it's too wide.
+    void* registerAddress(RegisterDescriptor) const;
+
+    // Memory callbacks called by the emulation code.
+    static uint64_t readMemory(void *emulator, uint64_t va, uint32_t nBytes);
+    static void writeMemory(void *emulator, uint64_t va, uint32_t nBytes, uint64_t value);
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#endif
+#endif
@@ -51,17 +51,20 @@ private:
     int indent_level;                                   // level of indentation (might be negative, but prefix() clips to zero
     std::string indent_string;                          // white space per indentation level
     int llvmVersion_;                                   // 1000000*major + 1000*minor + patch. e.g., 3005000 = llvm-3.5.0
+    bool emulation_;                                    // emit code that can be compiled and run by an Emulator?
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Real constructors
 protected:
     explicit RiscOperators(const BaseSemantics::SValuePtr &protoval, const SmtSolverPtr &solver = SmtSolverPtr())
-        : SymbolicSemantics::RiscOperators(protoval, solver), indent_level(0), indent_string("    "), llvmVersion_(0) {
+        : SymbolicSemantics::RiscOperators(protoval, solver), indent_level(0), indent_string("    "), llvmVersion_(0),
+          emulation_(false) {
         name("Llvm");
     }
 
     explicit RiscOperators(const BaseSemantics::StatePtr &state, const SmtSolverPtr &solver = SmtSolverPtr())
-        : SymbolicSemantics::RiscOperators(state, solver), indent_level(0), indent_string("    "), llvmVersion_(0) {
+        : SymbolicSemantics::RiscOperators(state, solver), indent_level(0), indent_string("    "), llvmVersion_(0),
+          emulation_(false) {
         name("Llvm");
     }
 
@@ -126,6 +129,21 @@ public:
     void llvmVersion(int v) { llvmVersion_ = v; }
     /** @} */
 
+    /** Property: Emit code for emulation.
+     *
+     *  Normally memory is accessed by converting machine addresses to LLVM pointers, registers are external globals, and
+     *  control flow that leaves the known functions is "unreachable". When this property is set, the emitted module is
+     *  instead self-contained so it can be compiled to a shared object and run by an @ref Emulator: registers are defined
+     *  as globals, memory is accessed through callbacks supplied at run time, indirect calls are dispatched to the known
+     *  functions, and control flow that can't be followed sets a flag and returns to the emulator. Each memory callback is
+     *  followed by a check of that flag, and an instruction's memory writes are emitted before its register definitions, so
+     *  an instruction whose memory access faults changes no registers and leaves the instruction pointer at its own address.
+     *
+     * @{ */
+    bool emulation() const { return emulation_; }
+    void emulation(bool b) { emulation_ = b; }
+    /** @} */
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Methods we override from the super class
 public:
@@ -214,6 +232,9 @@ public:
     /** Output LLVM global register definitions for the specified registers. */
     virtual void emit_register_definitions(std::ostream&, const RegisterDescriptors&);
 
+    /** Output the globals through which an @ref Emulator communicates with emulation code. */
+    virtual void emit_runtime_definitions(std::ostream&);
+
     /** Output LLVM global variable reads that are needed to define the specified registers and pending memory writes.  Since
      *  registers are stored in global variables and we routinely emit more than one register definition at a time, we need to
      *  first make sure that any global prerequisites for the definitions are saved in temporaries.  This is to handle cases
@@ -249,6 +270,16 @@ public:
     /** Output changed memory state. */
     virtual void emit_memory_writes(std::ostream&);
 
+    /** Output LLVM that returns to the emulator. The instruction pointer register must already be up to date. */
+    virtual void emit_exit(std::ostream&);
+
+    /** Output LLVM that returns to the emulator if a called function returned to it or a memory callback faulted. */
+    virtual void emit_exit_check(std::ostream&);
+
+    /** Output a call through a pointer. In emulation mode the pointer is compared with the entry addresses of the known
+     *  functions and the matching function is called, or the emulator is returned to if none match. */
+    virtual void emit_indirect_call(std::ostream&, const LeafPtr &target, const InstructionMap&);
+
     /** Output LLVM to bring the LLVM state up to date with respect to the ROSE state. */
     virtual void emit_changed_state(std::ostream&);
 
@@ -410,6 +441,16 @@ public:
     void quietErrors(bool b) { quiet_errors = b; }
     /** @} */
 
+    /** Property: Emit code for emulation.
+     *
+     *  If set, the emitted LLVM is a self-contained module that can be compiled to a shared object and run by an @ref
+     *  Emulator. See @ref RiscOperators::emulation. Only @ref transcodeInterpretation emits a complete module.
+     *
+     * @{ */
+    bool emulation() const;
+    void emulation(bool b);
+    /** @} */
+
     /** Emit LLVM file prologue.
      * @{ */
     void emitFilePrologue(std::ostream&);
@@ -422,6 +463,13 @@ public:
     std::string emitFunctionDeclarations(SgNode *ast);
     /** @} */
 
+    /** Emit a table of functions.  In emulation mode, emits the table that an @ref Emulator uses to find the LLVM function
+     *  for each function entry address in the specified AST. Emits nothing otherwise.
+     *  @{ */
+    void emitFunctionTable(SgNode *ast, std::ostream&);
+    std::string emitFunctionTable(SgNode *ast);
+    /** @} */
+
     /** Translate a single machine instruction to LLVM instructions.  LLVM instructions are emitted to the specified stream
      *  or returned as a string.
      * @{ */
@@ -444,7 +492,7 @@ public:
     /** @} */
 
     /** Transcode an entire binary interpretation. Unlike the lower-level transcoder methods, this one also emits register and
-     *  function declarations.
+     *  function declarations, and in emulation mode the function table.
      * @{ */
     void transcodeInterpretation(SgAsmInterpretation*, std::ostream&);
     std::string transcodeInterpretation(SgAsmInterpretation*);
@@ -5,6 +5,7 @@
 
 #include <BaseSemantics2.h>
 #include <MemoryCellState.h>
+#include <Sawyer/Map.h>
 
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/base_object.hpp>
@@ -35,7 +36,13 @@ typedef boost::shared_ptr<class MemoryCellList> MemoryCellListPtr;
  *  for users to define their own subclasses and use them in the semantic framework.
  *
  *  This implementation stores memory cells in reverse chronological order: the most recently created cells appear at the
- *  beginning of the list.  Subclasses, of course, are free to reorder the list however they want. */
+ *  beginning of the list.  Subclasses, of course, are free to reorder the list however they want.
+ *
+ *  The list is also indexed so that reading a one-byte cell at a concrete address doesn't need to scan the whole list. The
+ *  index holds the newest cell for each concrete address and, in chronological order, the cells whose addresses are not
+ *  concrete (or whose values are not one byte). A read at a concrete address finds its newest cell by map lookup and then
+ *  checks only the non-concrete cells that are newer than it, since a concrete address cannot alias a different concrete
+ *  address. Modifying the list through the non-const @ref get_cells discards the index, which is rebuilt by the next read. */
 class MemoryCellList: public MemoryCellState {
 public:
     typedef std::list<MemoryCellPtr> CellList;          /**< List of memory cells. */
@@ -44,6 +51,24 @@ protected:
     CellList cells;                                     // list of cells in reverse chronological order
     bool occlusionsErased_;                             // prune away old cells that are occluded by newer ones.
 
+private:
+    // A cell in the index. List iterators remain valid when other cells are inserted or erased.
+    struct IndexedCell {
+        size_t seq;                                     // order of insertion; newer cells have larger numbers
+        CellList::const_iterator cell;
+        IndexedCell(): seq(0) {}
+        IndexedCell(size_t seq, CellList::const_iterator cell): seq(seq), cell(cell) {}
+    };
+
+    // Concrete address width and value.
+    typedef std::pair<size_t, uint64_t> ConcreteAddress;
+
+    // The index is a cache of the cell list and is therefore updated by const methods.
+    mutable Sawyer::Container::Map<ConcreteAddress, IndexedCell> latestConcrete_; // newest one-byte cell at each address
+    mutable std::vector<IndexedCell> otherCells_;       // all other cells in chronological order
+    mutable size_t nextSeq_;                            // sequence number for the next indexed cell
+    mutable bool indexValid_;                           // whether the index describes the current cell list
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     // Serialization
 #ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
@@ -55,6 +80,7 @@ private:
         s & BOOST_SERIALIZATION_BASE_OBJECT_NVP(MemoryCellState);
         s & BOOST_SERIALIZATION_NVP(cells);
         s & BOOST_SERIALIZATION_NVP(occlusionsErased_);
+        indexValid_ = false;                            // the index is rebuilt when needed
     }
 #endif
 
@@ -62,17 +88,17 @@ private:
     // Real constructors
 protected:
     MemoryCellList()                                    // for serialization
-        : occlusionsErased_(false) {}
+        : occlusionsErased_(false), nextSeq_(1), indexValid_(true) {}
 
     explicit MemoryCellList(const MemoryCellPtr &protocell)
-        : MemoryCellState(protocell), occlusionsErased_(false) {}
+        : MemoryCellState(protocell), occlusionsErased_(false), nextSeq_(1), indexValid_(true) {}
 
     MemoryCellList(const SValuePtr &addrProtoval, const SValuePtr &valProtoval)
-        : MemoryCellState(addrProtoval, valProtoval), occlusionsErased_(false) {}
+        : MemoryCellState(addrProtoval, valProtoval), occlusionsErased_(false), nextSeq_(1), indexValid_(true) {}
 
     // deep-copy cell list so that modifying this new state does not modify the existing state
     MemoryCellList(const MemoryCellList &other)
-        : MemoryCellState(other), occlusionsErased_(other.occlusionsErased_) {
+        : MemoryCellState(other), occlusionsErased_(other.occlusionsErased_), nextSeq_(1), indexValid_(false) {
         for (CellList::const_iterator ci=other.cells.begin(); ci!=other.cells.end(); ++ci)
             cells.push_back((*ci)->clone());
     }
@@ -225,10 +251,27 @@ public:
         return retval;
     }
 
+    /** Scan all cells to find matching cells.
+     *
+     *  Returns the same cells as @ref scan starting at the beginning of the list, and sets @p cursor to the cell that
+     *  terminated the scan (the exact alias) or the end of the list. When the address is concrete and the cells are one byte
+     *  wide, the index is used to avoid scanning cells that cannot alias the address; otherwise this is the same as @ref scan,
+     *  which stops at the newest cell that must alias the address.
+     *
+     *  Symbolic addresses are not indexed yet. Indexing them by expression would only find the newest cell with the same
+     *  address, which is where @ref scan stops anyway, and every newer cell would still need a may-alias test. A useful index
+     *  would group cells by base expression and constant offset (such as the stack pointer plus a constant), since two such
+     *  addresses with the same base and different offsets cannot alias. */
+    CellList scanIndexed(CellList::const_iterator &cursor /*out*/, const SValuePtr &addr, size_t nBits,
+                         RiscOperators *addrOps, RiscOperators *valOps) const;
+
     /** Returns the list of all memory cells.
+     *
+     *  The non-const version discards the index since the caller might modify the list.
+     *
      * @{ */
     virtual const CellList& get_cells() const { return cells; }
-    virtual       CellList& get_cells()       { return cells; }
+    virtual       CellList& get_cells()       { indexValid_ = false; return cells; }
     /** @} */
 
     virtual MemoryCell::AddressSet getWritersUnion(const SValuePtr &addr, size_t nBits, RiscOperators *addrOps,
@@ -259,6 +302,16 @@ protected:
     // Insert a new cell at the head of the list.  The specified writers and I/O properties are used.
     virtual MemoryCellPtr insertReadCell(const SValuePtr &addr, const SValuePtr &value,
                                          const AddressSet &writers, const InputOutputPropertySet &props);
+
+    // Add the cell at the front of the list to the index after it's inserted, and remove a cell from the index before it's
+    // erased.
+    void indexInsertedCell();
+    void unindexErasedCell(CellList::const_iterator);
+
+private:
+    static bool isConcreteByte(const MemoryCellPtr&);
+    void indexCell(CellList::const_iterator) const;
+    void buildIndex() const;
 };
 
 } // namespace
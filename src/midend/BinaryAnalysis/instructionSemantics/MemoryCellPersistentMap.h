@@ -0,0 +1,162 @@
+#ifndef ROSE_BinaryAnalysis_InstructionSemantics2_MemoryCellPersistentMap_H
+#define ROSE_BinaryAnalysis_InstructionSemantics2_MemoryCellPersistentMap_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include <BaseSemantics2.h>
+#include <MemoryCellState.h>
+#include <PersistentMap.h>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/export.hpp>
+#include <boost/serialization/split_member.hpp>
+#include <boost/serialization/vector.hpp>
+
+namespace Rose {
+namespace BinaryAnalysis {
+namespace InstructionSemantics2 {
+namespace BaseSemantics {
+
+/** Shared-ownership pointer to a persistent map-based memory state. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class MemoryCellPersistentMap> MemoryCellPersistentMapPtr;
+
+/** Map-based memory state whose copies share cells.
+ *
+ *  This memory state has the same behavior as @ref MemoryCellMap: cells are looked up by a key generated from their address
+ *  by the pure virtual @ref generateCellKey, and addresses alias only if their keys are equal.  The difference is that the
+ *  cells are stored in a @ref PersistentMap, so copying the state (with @ref clone) takes constant time and space no matter
+ *  how many cells it has, and the original and the copy share all their cells until one of them is modified. Each write
+ *  thereafter costs time and space that is logarithmic in the number of cells. This makes it suitable for analyses that fork
+ *  the state at every branch of a path, such as @ref FeasiblePath.
+ *
+ *  Since cells are shared, a cell that's in the map is never modified. Writing to memory and merging states insert new cells,
+ *  and @ref traverse gives the visitor a copy of each cell. The cells returned by @ref matchingCells, @ref leadingCells, and
+ *  @ref findCell must not be modified. The only exception is @ref latestWrittenCell, which is not shared with any other state
+ *  until the state is copied and may therefore be adjusted after it's written, such as to update its writers. */
+class MemoryCellPersistentMap: public MemoryCellState {
+public:
+    /** Key used to look up memory cells. See @ref MemoryCellMap::CellKey. */
+    typedef uint64_t CellKey;
+
+    /** Persistent map of memory cells indexed by cell keys. */
+    typedef PersistentMap<CellKey, MemoryCellPtr> CellMap;
+
+protected:
+    CellMap cells;
+
+#ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
+private:
+    friend class boost::serialization::access;
+
+    template<class S>
+    void save(S &s, const unsigned /*version*/) const {
+        s & BOOST_SERIALIZATION_BASE_OBJECT_NVP(MemoryCellState);
+        std::vector<CellKey> keys = cells.keys();
+        std::vector<MemoryCellPtr> values = cells.values();
+        s & BOOST_SERIALIZATION_NVP(keys);
+        s & BOOST_SERIALIZATION_NVP(values);
+    }
+
+    template<class S>
+    void load(S &s, const unsigned /*version*/) {
+        s & BOOST_SERIALIZATION_BASE_OBJECT_NVP(MemoryCellState);
+        std::vector<CellKey> keys;
+        std::vector<MemoryCellPtr> values;
+        s & BOOST_SERIALIZATION_NVP(keys);
+        s & BOOST_SERIALIZATION_NVP(values);
+        ASSERT_require(keys.size() == values.size());
+        cells.clear();
+        for (size_t i=0; i<keys.size(); ++i)
+            cells.insert(keys[i], values[i]);
+    }
+
+    BOOST_SERIALIZATION_SPLIT_MEMBER();
+#endif
+
+protected:
+    MemoryCellPersistentMap() {}                        // for serialization
+
+    explicit MemoryCellPersistentMap(const MemoryCellPtr &protocell)
+        : MemoryCellState(protocell) {}
+
+    MemoryCellPersistentMap(const SValuePtr &addrProtoval, const SValuePtr &valProtoval)
+        : MemoryCellState(addrProtoval, valProtoval) {}
+
+    // The copy shares all cells with the original.
+    MemoryCellPersistentMap(const MemoryCellPersistentMap &other)
+        : MemoryCellState(other), cells(other.cells) {}
+
+private:
+    MemoryCellPersistentMap& operator=(MemoryCellPersistentMap&) /*delete*/;
+
+public:
+    /** Promote a base memory state pointer to a MemoryCellPersistentMap pointer. The memory state, @p x, must have a
+     *  MemoryCellPersistentMap dynamic type. */
+    static MemoryCellPersistentMapPtr promote(const MemoryStatePtr &x) {
+        MemoryCellPersistentMapPtr retval = boost::dynamic_pointer_cast<MemoryCellPersistentMap>(x);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+public:
+    /** Generate a cell lookup key. See @ref MemoryCellMap::generateCellKey. */
+    virtual CellKey generateCellKey(const SValuePtr &address) const = 0;
+
+    /** Look up memory cell for address.
+     *
+     *  Returns the memory cell for the specified address, or a null pointer if the cell does not exist. The cell must not be
+     *  modified since it might be shared with other states. */
+    virtual MemoryCellPtr findCell(const SValuePtr &addr) const;
+
+    /** Predicate to determine whether all bytes are present.
+     *
+     *  Returns true if bytes at the specified address and the following consecutive addresses are all present in this
+     *  memory state. */
+    virtual bool isAllPresent(const SValuePtr &address, size_t nBytes, RiscOperators *addrOps) const;
+
+    /** Number of cells in this state. */
+    size_t nCells() const {
+        return cells.size();
+    }
+
+    /** Number of map nodes created since this state was copied.
+     *
+     *  This is the storage used by this state that is not shared with the state from which it was copied, measured in map
+     *  nodes. Each node holds one cell pointer. See @ref PersistentMap::nNodesCreated. */
+    size_t nNodesCreated() const {
+        return cells.nNodesCreated();
+    }
+
+public:
+    virtual void clear() ROSE_OVERRIDE;
+    virtual bool merge(const MemoryStatePtr &other, RiscOperators *addrOps, RiscOperators *valOps) ROSE_OVERRIDE;
+    virtual SValuePtr readMemory(const SValuePtr &address, const SValuePtr &dflt,
+                                 RiscOperators *addrOps, RiscOperators *valOps) ROSE_OVERRIDE;
+    virtual SValuePtr peekMemory(const SValuePtr &address, const SValuePtr &dflt,
+                                 RiscOperators *addrOps, RiscOperators *valOps) ROSE_OVERRIDE;
+    virtual void writeMemory(const SValuePtr &address, const SValuePtr &value,
+                             RiscOperators *addrOps, RiscOperators *valOps) ROSE_OVERRIDE;
+    virtual void print(std::ostream&, Formatter&) const ROSE_OVERRIDE;
+    virtual std::vector<MemoryCellPtr> matchingCells(const MemoryCell::Predicate&) const ROSE_OVERRIDE;
+    virtual std::vector<MemoryCellPtr> leadingCells(const MemoryCell::Predicate&) const ROSE_OVERRIDE;
+    virtual void eraseMatchingCells(const MemoryCell::Predicate&) ROSE_OVERRIDE;
+    virtual void eraseLeadingCells(const MemoryCell::Predicate&) ROSE_OVERRIDE;
+    virtual void traverse(MemoryCell::Visitor&) ROSE_OVERRIDE;
+    virtual MemoryCell::AddressSet getWritersUnion(const SValuePtr &addr, size_t nBits, RiscOperators *addrOps,
+                                                   RiscOperators *valOps) ROSE_OVERRIDE;
+    virtual MemoryCell::AddressSet getWritersIntersection(const SValuePtr &addr, size_t nBits, RiscOperators *addrOps,
+                                                          RiscOperators *valOps) ROSE_OVERRIDE;
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
+BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::BaseSemantics::MemoryCellPersistentMap);
+#endif
+
+#endif
+#endif
@@ -8,6 +8,7 @@
 
 #include <boost/noncopyable.hpp>
 #include <boost/filesystem.hpp>
+#include <set>
 
 namespace Rose {
 namespace BinaryAnalysis {
@@ -446,6 +447,149 @@ private:
     }
 };
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Branch traces
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Control flow trace of a subordinate process.
+ *
+ *  Single stepping a process with the @ref Dispatcher costs a few system calls and context switches per instruction, which is
+ *  too slow for long-running specimens. A branch trace instead records only the transfers of control while the process runs
+ *  at nearly full speed. The instructions between the transfers are recovered afterward by decoding the specimen's memory,
+ *  and the result can be replayed through any semantic domain without the process.
+ *
+ *  Two collection methods are supported:
+ *
+ *  @li @ref BRANCH_RECORDS uses the Linux @c perf_event_open interface to sample the CPU's last branch records. Each sample
+ *  holds the most recent taken branches, and the samples are taken often enough that consecutive samples overlap and can be
+ *  stitched together. The hardware doesn't say how many branches occurred between two samples, so a sample that matches the
+ *  trace in more than one place, such as in a tight loop, is stitched at the largest overlap and counted as ambiguous. Samples
+ *  that don't overlap or that the kernel dropped are counted as gaps. Branches after the last sample are not recorded.
+ *
+ *  @li @ref BREAKPOINTS writes a trap instruction at the start of each basic block and records each trap. This costs a few
+ *  context switches per basic block instead of per instruction. The blocks are those reachable through direct branches from
+ *  the starting address plus those supplied by the caller. Returns and indirect branches are also trapped and single stepped
+ *  to find their targets, and the blocks reachable from a target are trapped when it's first reached, including code such as
+ *  shared libraries that was mapped after tracing started. The trace is exact unless a target is not in executable memory, in
+ *  which case the process runs untraced until the next trap and that place is counted as a gap.
+ *
+ *  Only the main thread of an x86 specimen on Linux is traced, and signal handlers make the trace inconsistent with the code.
+ *  The process should have the same memory layout as the memory map used for replay, such as when address randomization is
+ *  disabled. */
+class BranchTrace {
+public:
+    /** Method for collecting a trace. */
+    enum Method {
+        AUTO,                                           /**< Use branch records if available, otherwise breakpoints. */
+        BRANCH_RECORDS,                                 /**< Sample the hardware last branch records. */
+        BREAKPOINTS                                     /**< Trap at the start of each basic block. */
+    };
+
+    /** Settings for collecting a trace. */
+    struct Settings {
+        Method method;                                  /**< Collection method. */
+        size_t samplePeriod;                            /**< Branch instructions per sample; not more than the record depth. */
+        size_t bufferPages;                             /**< Size of the kernel's sample buffer in pages; a power of two. */
+        size_t maxBranches;                             /**< Stop tracing after this many branches. */
+
+        Settings()
+            : method(AUTO), samplePeriod(8), bufferPages(256), maxBranches(UNLIMITED) {}
+    };
+
+    /** Transfer of control from the last instruction of one straight-line run to the first instruction of the next. */
+    struct Branch {
+        rose_addr_t source;                             /**< Address of the branch instruction, or zero if unknown after a gap. */
+        rose_addr_t target;                             /**< Address of the next instruction executed. */
+        bool afterGap;                                  /**< Whether unrecorded branches occurred before this one. */
+
+        Branch()
+            : source(0), target(0), afterGap(false) {}
+
+        Branch(rose_addr_t source, rose_addr_t target)
+            : source(source), target(target), afterGap(false) {}
+
+        bool operator==(const Branch &other) const {
+            return source == other.source && target == other.target;
+        }
+    };
+
+private:
+    Method method_;                                     // method used to collect the trace
+    rose_addr_t startVa_;                               // address of the first instruction traced
+    std::vector<Branch> branches_;                      // branches in the order they occurred
+    size_t nGaps_;                                      // number of places where branches are missing
+    size_t nAmbiguous_;                                 // number of samples that could be stitched more than one way
+
+public:
+    /** Construct an empty trace. */
+    BranchTrace()
+        : method_(AUTO), startVa_(0), nGaps_(0), nAmbiguous_(0) {}
+
+    /** Collect a trace by running a process.
+     *
+     *  Runs the subordinate from its current instruction until it terminates or @p settings.maxBranches branches are
+     *  recorded. The @p blockHeads are starting addresses of basic blocks, such as those found by a partitioner, and are used
+     *  only by the @ref BREAKPOINTS method, which would otherwise find them while tracing at the cost of additional stops.
+     *  Throws an @ref Exception if the requested method can't be used. */
+    static BranchTrace collect(const Debugger::Ptr&, const std::set<rose_addr_t> &blockHeads,
+                               const Settings &settings = Settings());
+
+    /** Whether this host can sample hardware branch records. */
+    static bool isHardwareTracingAvailable();
+
+    /** Property: Method used to collect the trace. */
+    Method method() const {
+        return method_;
+    }
+
+    /** Property: Address of the first instruction traced. */
+    rose_addr_t startVa() const {
+        return startVa_;
+    }
+
+    /** Property: Branches in the order they occurred. */
+    const std::vector<Branch>& branches() const {
+        return branches_;
+    }
+
+    /** Property: Number of places where branches are missing. */
+    size_t nGaps() const {
+        return nGaps_;
+    }
+
+    /** Property: Number of hardware samples that could be stitched into the trace more than one way. */
+    size_t nAmbiguous() const {
+        return nAmbiguous_;
+    }
+
+    /** Whether the trace is known to have every branch. */
+    bool isExact() const {
+        return 0 == nGaps_ && 0 == nAmbiguous_;
+    }
+
+    /** Addresses of the executed instructions.
+     *
+     *  Expands the trace by decoding the specimen's code from the memory map, which must be the same as in the traced process.
+     *  The straight-line run before a gap ends at the first instruction that can't fall through. Throws an @ref Exception if
+     *  the trace is not consistent with the code. */
+    std::vector<rose_addr_t> instructionAddresses(const MemoryMap::Ptr&, Disassembler*) const;
+
+    /** Replay the trace through semantics.
+     *
+     *  Decodes each instruction of the expanded trace and processes it with the dispatcher, whose state was initialized by the
+     *  caller. If the instruction pointer is not concrete after an instruction, it's set to the next address from the trace so
+     *  the state follows the traced path. Replay stops at the end of the trace, at the first gap, or when a concrete
+     *  instruction pointer disagrees with the trace. Returns the number of instructions processed. */
+    size_t replay(const BaseSemantics::DispatcherPtr&, const MemoryMap::Ptr&, Disassembler*) const;
+
+private:
+    std::vector<rose_addr_t> expand(const MemoryMap::Ptr&, Disassembler*, bool stopAtGap) const;
+    void appendSample(const std::vector<Branch>&, bool afterLoss, size_t samplePeriod);
+    void appendBreakpointBranch(const Branch&, bool afterGap);
+    void collectBranchRecords(const Debugger::Ptr&, const Settings&);
+    void collectBreakpoints(const Debugger::Ptr&, const std::set<rose_addr_t> &blockHeads, const Settings&);
+};
+
 
 } // namespace
 } // namespace
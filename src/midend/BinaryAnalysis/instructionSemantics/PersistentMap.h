@@ -0,0 +1,277 @@
+#ifndef ROSE_BinaryAnalysis_InstructionSemantics2_PersistentMap_H
+#define ROSE_BinaryAnalysis_InstructionSemantics2_PersistentMap_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include <Sawyer/Optional.h>
+#include <algorithm>
+#include <boost/shared_ptr.hpp>
+#include <functional>
+#include <utility>
+#include <vector>
+
+namespace Rose {
+namespace BinaryAnalysis {
+namespace InstructionSemantics2 {
+namespace BaseSemantics {
+
+/** Map whose copies share structure.
+ *
+ *  This is a balanced binary tree (AVL) whose nodes are never modified after they're created. Copying the map copies only a
+ *  pointer to the root, and modifying a map creates new nodes for the path from the root to the modified node while sharing
+ *  all other nodes with the maps from which it was copied. Therefore copying is constant time, and each insertion or erasure
+ *  is logarithmic in both time and space regardless of how many copies exist.
+ *
+ *  The keys and values are copied into the nodes and must not be modified through pointers that are shared with other
+ *  data structures since they might be shared by more than one map.  The interface is a subset of @ref
+ *  Sawyer::Container::Map. */
+template<class K, class V, class Cmp = std::less<K> >
+class PersistentMap {
+public:
+    typedef K Key;                                      /**< Type of keys. */
+    typedef V Value;                                    /**< Type of values. */
+
+private:
+    struct Node {
+        Key key;
+        Value value;
+        size_t height;                                  // height of the subtree rooted here, leaves are one
+        boost::shared_ptr<const Node> left, right;
+
+        Node(const Key &key, const Value &value, const boost::shared_ptr<const Node> &left,
+             const boost::shared_ptr<const Node> &right)
+            : key(key), value(value), height(1 + std::max(left ? left->height : 0, right ? right->height : 0)),
+              left(left), right(right) {}
+    };
+    typedef boost::shared_ptr<const Node> NodePtr;
+
+    NodePtr root_;
+    size_t size_;
+    size_t nNodesCreated_;                              // nodes created by this map since it was constructed or copied
+    Cmp cmp_;
+
+public:
+    /** Construct an empty map. */
+    PersistentMap()
+        : size_(0), nNodesCreated_(0) {}
+
+    /** Copy constructor. The copy shares all nodes with @p other. */
+    PersistentMap(const PersistentMap &other)
+        : root_(other.root_), size_(other.size_), nNodesCreated_(0), cmp_(other.cmp_) {}
+
+    /** Assignment. This map shares all nodes with @p other. */
+    PersistentMap& operator=(const PersistentMap &other) {
+        root_ = other.root_;
+        size_ = other.size_;
+        nNodesCreated_ = 0;
+        cmp_ = other.cmp_;
+        return *this;
+    }
+
+    /** Number of key/value pairs. */
+    size_t size() const { return size_; }
+
+    /** Whether the map is empty. */
+    bool isEmpty() const { return 0 == size_; }
+
+    /** Whether a key exists. */
+    bool exists(const Key &key) const { return findNode(key) != NULL; }
+
+    /** Value for a key if it exists. */
+    Sawyer::Optional<Value> getOptional(const Key &key) const {
+        const Node *node = findNode(key);
+        return node ? Sawyer::Optional<Value>(node->value) : Sawyer::Optional<Value>();
+    }
+
+    /** Value for a key, or a default-constructed value if the key doesn't exist. */
+    Value getOrDefault(const Key &key) const {
+        const Node *node = findNode(key);
+        return node ? node->value : Value();
+    }
+
+    /** Insert or replace the value for a key. */
+    PersistentMap& insert(const Key &key, const Value &value) {
+        bool inserted = false;
+        root_ = insertAt(root_, key, value, inserted);
+        if (inserted)
+            ++size_;
+        return *this;
+    }
+
+    /** Erase a key if it exists. */
+    PersistentMap& erase(const Key &key) {
+        bool erased = false;
+        root_ = eraseAt(root_, key, erased);
+        if (erased)
+            --size_;
+        return *this;
+    }
+
+    /** Erase all keys. Nodes shared with other maps are not affected. */
+    PersistentMap& clear() {
+        root_ = NodePtr();
+        size_ = 0;
+        return *this;
+    }
+
+    /** All keys in increasing order. */
+    std::vector<Key> keys() const {
+        std::vector<Key> retval;
+        retval.reserve(size_);
+        appendKeys(root_.get(), retval);
+        return retval;
+    }
+
+    /** All values in order of increasing keys. */
+    std::vector<Value> values() const {
+        std::vector<Value> retval;
+        retval.reserve(size_);
+        appendValues(root_.get(), retval);
+        return retval;
+    }
+
+    /** All key/value pairs in order of increasing keys. */
+    std::vector<std::pair<Key, Value> > nodes() const {
+        std::vector<std::pair<Key, Value> > retval;
+        retval.reserve(size_);
+        appendNodes(root_.get(), retval);
+        return retval;
+    }
+
+    /** Whether this map and @p other have the same root, and are therefore equal without comparing their contents. */
+    bool sharesAll(const PersistentMap &other) const {
+        return root_ == other.root_;
+    }
+
+    /** Number of nodes created since this map was constructed or copied.
+     *
+     *  This is the amount of storage by which this map differs from the map from which it was copied (plus nodes that have
+     *  since been freed), and is about the logarithm of the size times the number of insertions and erasures. */
+    size_t nNodesCreated() const { return nNodesCreated_; }
+
+private:
+    const Node* findNode(const Key &key) const {
+        const Node *node = root_.get();
+        while (node) {
+            if (cmp_(key, node->key)) {
+                node = node->left.get();
+            } else if (cmp_(node->key, key)) {
+                node = node->right.get();
+            } else {
+                return node;
+            }
+        }
+        return NULL;
+    }
+
+    static size_t height(const NodePtr &node) {
+        return node ? node->height : 0;
+    }
+
+    NodePtr makeNode(const Key &key, const Value &value, const NodePtr &left, const NodePtr &right) {
+        ++nNodesCreated_;
+        return NodePtr(new Node(key, value, left, right));
+    }
+
+    // Create a node from parts whose heights differ by at most two, rotating if necessary so that the heights of the new
+    // node's children differ by at most one.
+    NodePtr balance(const Key &key, const Value &value, const NodePtr &left, const NodePtr &right) {
+        size_t hl = height(left), hr = height(right);
+        if (hl > hr + 1) {
+            if (height(left->left) >= height(left->right)) {
+                return makeNode(left->key, left->value, left->left, makeNode(key, value, left->right, right));
+            } else {
+                const NodePtr &lr = left->right;
+                return makeNode(lr->key, lr->value, makeNode(left->key, left->value, left->left, lr->left),
+                                makeNode(key, value, lr->right, right));
+            }
+        } else if (hr > hl + 1) {
+            if (height(right->right) >= height(right->left)) {
+                return makeNode(right->key, right->value, makeNode(key, value, left, right->left), right->right);
+            } else {
+                const NodePtr &rl = right->left;
+                return makeNode(rl->key, rl->value, makeNode(key, value, left, rl->left),
+                                makeNode(right->key, right->value, rl->right, right->right));
+            }
+        } else {
+            return makeNode(key, value, left, right);
+        }
+    }
+
+    NodePtr insertAt(const NodePtr &node, const Key &key, const Value &value, bool &inserted /*out*/) {
+        if (!node) {
+            inserted = true;
+            return makeNode(key, value, NodePtr(), NodePtr());
+        } else if (cmp_(key, node->key)) {
+            return balance(node->key, node->value, insertAt(node->left, key, value, inserted), node->right);
+        } else if (cmp_(node->key, key)) {
+            return balance(node->key, node->value, node->left, insertAt(node->right, key, value, inserted));
+        } else {
+            return makeNode(key, value, node->left, node->right);
+        }
+    }
+
+    // Erase the smallest key of a non-empty subtree, and return that node's key and value.
+    NodePtr eraseMinimum(const NodePtr &node, Key &key /*out*/, Value &value /*out*/) {
+        if (!node->left) {
+            key = node->key;
+            value = node->value;
+            return node->right;
+        }
+        return balance(node->key, node->value, eraseMinimum(node->left, key, value), node->right);
+    }
+
+    NodePtr eraseAt(const NodePtr &node, const Key &key, bool &erased /*out*/) {
+        if (!node) {
+            return node;
+        } else if (cmp_(key, node->key)) {
+            NodePtr left = eraseAt(node->left, key, erased);
+            return erased ? balance(node->key, node->value, left, node->right) : node;
+        } else if (cmp_(node->key, key)) {
+            NodePtr right = eraseAt(node->right, key, erased);
+            return erased ? balance(node->key, node->value, node->left, right) : node;
+        } else {
+            erased = true;
+            if (!node->left)
+                return node->right;
+            if (!node->right)
+                return node->left;
+            Key successorKey = node->key;
+            Value successorValue = node->value;
+            NodePtr right = eraseMinimum(node->right, successorKey, successorValue);
+            return balance(successorKey, successorValue, node->left, right);
+        }
+    }
+
+    static void appendKeys(const Node *node, std::vector<Key> &keys /*in,out*/) {
+        if (node) {
+            appendKeys(node->left.get(), keys);
+            keys.push_back(node->key);
+            appendKeys(node->right.get(), keys);
+        }
+    }
+
+    static void appendValues(const Node *node, std::vector<Value> &values /*in,out*/) {
+        if (node) {
+            appendValues(node->left.get(), values);
+            values.push_back(node->value);
+            appendValues(node->right.get(), values);
+        }
+    }
+
+    static void appendNodes(const Node *node, std::vector<std::pair<Key, Value> > &nodes /*in,out*/) {
+        if (node) {
+            appendNodes(node->left.get(), nodes);
+            nodes.push_back(std::make_pair(node->key, node->value));
+            appendNodes(node->right.get(), nodes);
+        }
+    }
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#endif
+#endif
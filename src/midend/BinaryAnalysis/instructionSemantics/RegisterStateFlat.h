@@ -0,0 +1,160 @@
+#ifndef ROSE_BinaryAnalysis_InstructionSemantics2_RegisterStateFlat_H
+#define ROSE_BinaryAnalysis_InstructionSemantics2_RegisterStateFlat_H
+#include <rosePublicConfig.h>
+#ifdef ROSE_BUILD_BINARY_ANALYSIS_SUPPORT
+
+#include <RegisterStateGeneric.h>
+
+#include <boost/serialization/access.hpp>
+#include <boost/serialization/base_object.hpp>
+#include <boost/serialization/export.hpp>
+
+namespace Rose {
+namespace BinaryAnalysis {
+namespace InstructionSemantics2 {
+namespace BaseSemantics {
+
+/** Shared-ownership pointer to flat register states. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class RegisterStateFlat> RegisterStateFlatPtr;
+
+/** A RegisterState for architectures with a fixed set of registers.
+ *
+ *  This is a @ref RegisterStateGeneric that is specialized for the common case where every register is accessed as some part
+ *  of one of the largest registers in the register dictionary, such as x86 AL, AX, EAX as parts of RAX, or AArch64 W0 as part
+ *  of X0.  The largest registers are numbered densely by their major and minor numbers when the state is created, and each
+ *  stored register is kept as a single full-width location.  Reading or writing part of such a register finds the location
+ *  by array index and extracts or inserts the accessed bits, without searching the map of stored locations and without
+ *  splitting the location into pieces.
+ *
+ *  The generic representation is still the one that's stored and everything that inspects it (printing, merging, writer and
+ *  property tracking, etc.) works as for @ref RegisterStateGeneric. Accesses that don't fit the dense layout, such as
+ *  registers whose major/minor pair is not one of the largest registers or registers whose stored parts cannot be combined
+ *  because @ref accessCreatesLocations or @ref accessModifiesExistingLocations is clear, are handled by @ref
+ *  RegisterStateGeneric.  After such an access the stored parts are combined into a full-width location again when allowed.
+ *
+ *  Since locations are never split, reading a sub-register in a symbolic domain returns an extract of the full-width value
+ *  rather than a new variable for that sub-register's location. The values are equivalent, but the expressions (and thus the
+ *  output from @ref print) can differ from those of @ref RegisterStateGeneric. */
+class RegisterStateFlat: public RegisterStateGeneric {
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Data members
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+private:
+    // Dense numbering of the largest registers of a register dictionary. A layout depends only on the dictionary and is
+    // shared by all copies of a state.
+    struct Layout {
+        const RegisterDictionary *regdict;              // dictionary from which this layout was created
+        std::vector<size_t> majorBase;                  // index of first slot for each major number, or INVALID_INDEX
+        std::vector<size_t> nMinors;                    // number of slots for each major number
+        std::vector<RegisterDescriptor> largest;        // largest register for each slot, or empty if none or ambiguous
+        explicit Layout(const RegisterDictionary*);
+    };
+    typedef boost::shared_ptr<const Layout> LayoutPtr;
+
+    LayoutPtr layout_;                                  // created lazily from the current register dictionary
+    std::vector<RegPairs*> slots_;                      // stored parts of each slot, or null if not looked up yet
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Serialization
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+#ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
+private:
+    friend class boost::serialization::access;
+
+    template<class S>
+    void serialize(S &s, const unsigned /*version*/) {
+        s & BOOST_SERIALIZATION_BASE_OBJECT_NVP(RegisterStateGeneric);
+        slots_.clear();                                 // slots point into the stored registers and are found again lazily
+    }
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Normal constructors
+    //
+    // These are protected because objects of this class are reference counted and always allocated on the heap.
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+protected:
+    RegisterStateFlat() {}                              // for serialization
+
+    RegisterStateFlat(const SValuePtr &protoval, const RegisterDictionary *regdict)
+        : RegisterStateGeneric(protoval, regdict) {}
+
+    // The copy has its own stored registers, so the slots are found again lazily.
+    RegisterStateFlat(const RegisterStateFlat &other)
+        : RegisterStateGeneric(other), layout_(other.layout_) {}
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Static allocating constructors
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+    /** Instantiate a new register state. See @ref RegisterStateGeneric::instance for a description of the arguments. */
+    static RegisterStateFlatPtr instance(const SValuePtr &protoval, const RegisterDictionary *regdict) {
+        return RegisterStateFlatPtr(new RegisterStateFlat(protoval, regdict));
+    }
+
+    /** Instantiate a new copy of an existing register state. */
+    static RegisterStateFlatPtr instance(const RegisterStateFlatPtr &other) {
+        return RegisterStateFlatPtr(new RegisterStateFlat(*other));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Virtual constructors
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+    virtual RegisterStatePtr create(const SValuePtr &protoval, const RegisterDictionary *regdict) const ROSE_OVERRIDE {
+        return instance(protoval, regdict);
+    }
+
+    virtual RegisterStatePtr clone() const ROSE_OVERRIDE {
+        return RegisterStateFlatPtr(new RegisterStateFlat(*this));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Dynamic pointer casts
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+    /** Run-time promotion of a base register state pointer to a RegisterStateFlat pointer. This is a checked conversion--it
+     *  will fail if @p from does not point to a RegisterStateFlat object. */
+    static RegisterStateFlatPtr promote(const RegisterStatePtr &from) {
+        RegisterStateFlatPtr retval = boost::dynamic_pointer_cast<RegisterStateFlat>(from);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Inherited non-constructors
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+public:
+    virtual void clear() ROSE_OVERRIDE;
+    virtual SValuePtr readRegister(RegisterDescriptor reg, const SValuePtr &dflt, RiscOperators *ops) ROSE_OVERRIDE;
+    virtual SValuePtr peekRegister(RegisterDescriptor reg, const SValuePtr &dflt, RiscOperators *ops) ROSE_OVERRIDE;
+    virtual void writeRegister(RegisterDescriptor reg, const SValuePtr &value, RiscOperators *ops) ROSE_OVERRIDE;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Non-public APIs
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+protected:
+    // Index of the slot whose largest register contains the specified register, or INVALID_INDEX if the register doesn't fit
+    // the dense layout.
+    size_t slotIndex(RegisterDescriptor);
+
+    // The single stored location that contains the specified register, or null if the register doesn't fit the dense layout
+    // or is not stored as a single location.
+    RegPair* flatLocation(RegisterDescriptor);
+
+    // Combine the stored parts of the largest register containing the specified register into a single location if that's
+    // allowed by the access properties. Bits that are not stored are initialized like readRegister would initialize them.
+    void combineLocations(RegisterDescriptor, RiscOperators*);
+};
+
+} // namespace
+} // namespace
+} // namespace
+} // namespace
+
+#ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
+BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::BaseSemantics::RegisterStateFlat);
+#endif
+
+#endif
+#endif
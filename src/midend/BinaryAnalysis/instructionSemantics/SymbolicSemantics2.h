@@ -15,6 +15,7 @@
 #include "RegisterStateGeneric.h"
 #include "MemoryCellList.h"
 #include "MemoryCellMap.h"
+#include "MemoryCellPersistentMap.h"
 
 #include <boost/serialization/access.hpp>
 #include <boost/serialization/base_object.hpp>
@@ -743,6 +744,107 @@ public:
 
 
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+//                                      Persistent map-based Memory state
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Shared-ownership pointer to persistent symbolic memory state. See @ref heap_object_shared_ownership. */
+typedef boost::shared_ptr<class MemoryPersistentMapState> MemoryPersistentMapStatePtr;
+
+/** Byte-addressable memory whose copies share cells.
+ *
+ *  This memory state behaves like @ref MemoryMapState: cells are indexed by the hash of their symbolic address and aliasing is
+ *  not resolved. The cells are stored in a persistent map (see @ref BaseSemantics::MemoryCellPersistentMap), so copying the
+ *  state takes constant time and the copy shares cells with the original until either is written. Analyses that copy the
+ *  state at each branch of a path therefore pay only for the memory writes made after each branch.
+ *
+ *  @sa MemoryMapState */
+class MemoryPersistentMapState: public BaseSemantics::MemoryCellPersistentMap {
+public:
+    typedef BaseSemantics::MemoryCellPersistentMap Super;
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Serialization
+#ifdef ROSE_HAVE_BOOST_SERIALIZATION_LIB
+private:
+    friend class boost::serialization::access;
+
+    template<class S>
+    void serialize(S &s, const unsigned /*version*/) {
+        s & BOOST_SERIALIZATION_BASE_OBJECT_NVP(Super);
+    }
+#endif
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Real constructors
+protected:
+    MemoryPersistentMapState() {}                       // for serialization
+
+    explicit MemoryPersistentMapState(const BaseSemantics::MemoryCellPtr &protocell)
+        : BaseSemantics::MemoryCellPersistentMap(protocell) {}
+
+    MemoryPersistentMapState(const BaseSemantics::SValuePtr &addrProtoval, const BaseSemantics::SValuePtr &valProtoval)
+        : BaseSemantics::MemoryCellPersistentMap(addrProtoval, valProtoval) {}
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Static allocating constructors
+public:
+    /** Instantiates a new memory state having specified prototypical cells and value. */
+    static MemoryPersistentMapStatePtr instance(const BaseSemantics::MemoryCellPtr &protocell) {
+        return MemoryPersistentMapStatePtr(new MemoryPersistentMapState(protocell));
+    }
+
+    /** Instantiates a new memory state having specified prototypical value.  This constructor uses BaseSemantics::MemoryCell
+     *  as the cell type. */
+    static MemoryPersistentMapStatePtr instance(const BaseSemantics::SValuePtr &addrProtoval,
+                                                const BaseSemantics::SValuePtr &valProtoval) {
+        return MemoryPersistentMapStatePtr(new MemoryPersistentMapState(addrProtoval, valProtoval));
+    }
+
+    /** Instantiates a new copy of an existing state. The copy shares cells with @p other. */
+    static MemoryPersistentMapStatePtr instance(const MemoryPersistentMapStatePtr &other) {
+        return MemoryPersistentMapStatePtr(new MemoryPersistentMapState(*other));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Virtual constructors
+public:
+    /** Virtual constructor. Creates a memory state having specified prototypical value.  This constructor uses
+     * BaseSemantics::MemoryCell as the cell type. */
+    virtual BaseSemantics::MemoryStatePtr create(const BaseSemantics::SValuePtr &addrProtoval,
+                                                 const BaseSemantics::SValuePtr &valProtoval) const ROSE_OVERRIDE {
+        return instance(addrProtoval, valProtoval);
+    }
+
+    /** Virtual constructor. Creates a new memory state having specified prototypical cells and value. */
+    virtual BaseSemantics::MemoryStatePtr create(const BaseSemantics::MemoryCellPtr &protocell) const {
+        return instance(protocell);
+    }
+
+    /** Virtual copy constructor. Creates a new copy of this memory state in constant time. */
+    virtual BaseSemantics::MemoryStatePtr clone() const ROSE_OVERRIDE {
+        return BaseSemantics::MemoryStatePtr(new MemoryPersistentMapState(*this));
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Dynamic pointer casts
+public:
+    /** Recasts a base pointer to a persistent symbolic memory state. This is a checked cast that will fail if the specified
+     *  pointer does not have a run-time type that is a SymbolicSemantics::MemoryPersistentMapState or subclass thereof. */
+    static MemoryPersistentMapStatePtr promote(const BaseSemantics::MemoryStatePtr &x) {
+        MemoryPersistentMapStatePtr retval = boost::dynamic_pointer_cast<MemoryPersistentMapState>(x);
+        ASSERT_not_null(retval);
+        return retval;
+    }
+
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    // Methods we override from the super class (documented in the super class)
+public:
+    virtual CellKey generateCellKey(const BaseSemantics::SValuePtr &addr_) const ROSE_OVERRIDE;
+};
+
+
+
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
 //                                      Default memory state
 ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -1230,6 +1332,7 @@ public:
 BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::SymbolicSemantics::SValue);
 BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::SymbolicSemantics::MemoryListState);
 BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::SymbolicSemantics::MemoryMapState);
+BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::SymbolicSemantics::MemoryPersistentMapState);
 BOOST_CLASS_EXPORT_KEY(Rose::BinaryAnalysis::InstructionSemantics2::SymbolicSemantics::RiscOperators);
 #endif
 
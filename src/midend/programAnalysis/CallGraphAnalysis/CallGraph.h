@@ -13,7 +13,10 @@
 #include <string>
 #include <functional>
 #include <queue>
+#include <set>
 #include <boost/foreach.hpp>
+#include <boost/function.hpp>
+#include <boost/shared_ptr.hpp>
 #include <boost/unordered_map.hpp>
 
 class FunctionData;
@@ -119,11 +122,23 @@ class ROSE_DLL_API FunctionData
 
     bool isDefined (); 
 
-    FunctionData(SgFunctionDeclaration* functionDeclaration, SgProject *project, ClassHierarchyWrapper * );
+    //! Resolved callees of each call site (function call expression or constructor initializer)
+    typedef boost::unordered_map<SgExpression*, Rose_STL_Container<SgFunctionDeclaration*> > CallSiteTargets;
+
+    //! Computes the callees of a function. If callSiteTargets is not null, call sites that already have an entry
+    //! there are not resolved again, and the resolutions of the other call sites are added to it.
+    FunctionData(SgFunctionDeclaration* functionDeclaration, SgProject *project, ClassHierarchyWrapper *,
+                 CallSiteTargets *callSiteTargets = NULL);
 
     //! All the callees of this function
     Rose_STL_Container<SgFunctionDeclaration *> functionList;
 
+    //! All the call sites in the definition of this function
+    std::vector<SgExpression*> callSites;
+
+    //! Number of call sites whose targets were resolved rather than found in the cache
+    size_t nResolvedCallSites;
+
     SgFunctionDeclaration* functionDeclaration;
 
     Rose_STL_Container<SgMemberFunctionDeclaration*> *findPointsToVirtualFunctions ( SgMemberFunctionDeclaration * );
@@ -164,13 +179,59 @@ class ROSE_DLL_API CallGraphBuilder
     //! Retrieve the node matching a function declaration (using mangled name to resolve across translation units)
     SgGraphNode * getGraphNodeFor(SgFunctionDeclaration * fdecl) const;
 
+    //! Update the call graph after the given functions were modified or added.
+    //!
+    //! Only the outgoing edges of these functions are recomputed. Callees that are not yet in the graph (e.g. functions
+    //! created by the outliner) are added and analyzed as well. The class hierarchy and the resolved targets of the call
+    //! sites in unmodified functions are reused from the previous build or update, except that calls through pointers
+    //! and virtual calls are resolved again whenever functions are added. Transformations that add classes or remove
+    //! functions need a rebuildCallGraph or a full buildCallGraph. The selection predicate of the last buildCallGraph is
+    //! used.
+    void updateCallGraph(const std::vector<SgFunctionDeclaration*> &modifiedFunctions);
+    //! Update the call graph for all functions whose definitions contain IR nodes marked as modified.
+    //!
+    //! The isModified flags are not reset (the unparser relies on them), so functions stay selected until the flags are
+    //! cleared, e.g. with unsetNodesMarkedAsModified.
+    void updateCallGraph();
+    //! Build the whole call graph again with the predicate of the last buildCallGraph.
+    //!
+    //! Unlike buildCallGraph, which resolves every call site from scratch, this reuses the resolved targets of named
+    //! callees in functions that are not marked as modified.
+    void rebuildCallGraph();
+    //! Functions whose definitions contain IR nodes marked as modified (see SgNode::get_isModified)
+    std::vector<SgFunctionDeclaration*> findModifiedFunctions() const;
+    //! Number of call sites whose targets were resolved, rather than reused, by the last build or update
+    size_t nResolvedCallSites() const { return nResolved; }
+
   private:
+    typedef boost::unordered_map<SgFunctionDeclaration*, std::vector<SgExpression*> > FunctionCallSites;
+
+    SgGraphNode * addGraphNodeFor(SgFunctionDeclaration *unique);
+    void retainCallSiteTargets();
+    FunctionData analyzeFunction(SgFunctionDeclaration *unique);
+    void rememberCallSites(const FunctionData &fdata);
+    void forgetCallSites(SgFunctionDeclaration *unique);
+    void forgetIndirectCallSites(SgFunctionDeclaration *unique);
+
     SgProject *project;
     SgIncidenceDirectedGraph *graph;
     //We map each function to the corresponding graph node
     typedef boost::unordered_map<SgFunctionDeclaration*, SgGraphNode*> GraphNodes;
     GraphNodes graphNodes;
 
+    // State kept between buildCallGraph and updateCallGraph
+    boost::function<bool(SgFunctionDeclaration*)> isSelectedFunction;
+    boost::shared_ptr<ClassHierarchyWrapper> classHierarchy;
+    FunctionData::CallSiteTargets callSiteTargets;
+    FunctionCallSites functionCallSites;
+    std::set<SgExpression*> indirectCallSites;
+    std::set<SgFunctionDeclaration*> indirectCallers;
+    size_t nResolved;
+    bool reuseCallSites;                                // set by rebuildCallGraph
+
+    // Cached call sites of the previous build that have not been claimed by a function of the current build
+    FunctionData::CallSiteTargets previousCallSiteTargets;
+    FunctionCallSites previousCallSites;
 };
 //! Generate a dot graph named 'fileName' from a call graph 
 //TODO this function is    not defined? If so, need to be removed. 
@@ -183,33 +244,37 @@ class ROSE_DLL_API GetOneFuncDeclarationPerFunction :  public std::unary_functio
     result_type operator()(SgNode* node );
 };
 
+//! Adds additional constraints to a call graph predicate. It makes no sense to analyze non-instantiated templates.
+template<typename Predicate>
+struct CallGraphFunctionSelector {
+    Predicate pred;
+    CallGraphFunctionSelector(const Predicate &pred): pred(pred) {}
+    bool operator()(SgFunctionDeclaration *f) {
+     // TV (10/26/2018): FIXME ROSE-1487
+     // assert(!f || f==f->get_firstNondefiningDeclaration()); // node uniqueness test
+#if 0
+     // DQ (8/25/2016): This is not a meaningful test since all functions will be in the memory pool, including template functions and template member functions.
+        if(isSgTemplateFunctionDeclaration(f)||isSgTemplateMemberFunctionDeclaration(f)) {
+          std::cerr<<"Error: CallGraphBuilder: call referring to node "<<f->class_name()<<" :: function-name:"<<f->get_qualified_name()<<std::endl;
+        }
+#endif
+        return f && f==f->get_firstNondefiningDeclaration() &&  !isSgTemplateMemberFunctionDeclaration(f) && !isSgTemplateFunctionDeclaration(f) && pred(f);
+    }
+};
+
 template<typename Predicate>
 void
 CallGraphBuilder::buildCallGraph(Predicate pred)
 {
-    // Adds additional constraints to the predicate. It makes no sense to analyze non-instantiated templates.
-    struct isSelected {
-        Predicate &pred;
-        isSelected(Predicate &pred): pred(pred) {}
-        bool operator()(SgNode *node) {
-            SgFunctionDeclaration *f = isSgFunctionDeclaration(node);
-         // TV (10/26/2018): FIXME ROSE-1487
-         // assert(!f || f==f->get_firstNondefiningDeclaration()); // node uniqueness test
-#if 0
-         // DQ (8/25/2016): This is not a meaningful test since all functions will be in the memory pool, including template functions and template member functions.
-            if(isSgTemplateFunctionDeclaration(f)||isSgTemplateMemberFunctionDeclaration(f)) {
-              std::cerr<<"Error: CallGraphBuilder: call referring to node "<<f->class_name()<<" :: function-name:"<<f->get_qualified_name()<<std::endl;
-            }
-#endif
-            return f && f==f->get_firstNondefiningDeclaration() &&  !isSgTemplateMemberFunctionDeclaration(f) && !isSgTemplateFunctionDeclaration(f) && pred(f);
-        }
-    };
+    CallGraphFunctionSelector<Predicate> isSelected(pred);
 
     // Add nodes to the graph by querying the memory pool for function declarations, mapping them to unique declarations
     // that can be used as keys in a map (using get_firstNondefiningDeclaration()), and filtering according to the predicate.
     graph = new SgIncidenceDirectedGraph();
     std::vector<FunctionData> callGraphData;
-    ClassHierarchyWrapper classHierarchy(project);
+    isSelectedFunction = isSelected;
+    classHierarchy.reset(new ClassHierarchyWrapper(project));
+    retainCallSiteTargets();
     graphNodes.clear();
     VariantVector vv(V_SgFunctionDeclaration);
     GetOneFuncDeclarationPerFunction defFunc;
@@ -221,28 +286,26 @@ CallGraphBuilder::buildCallGraph(Predicate pred)
         printf ("In buildCallGraph(): loop over functions from memory pool: fdecl  = %p = %s name = %s \n",fdecl,fdecl->class_name().c_str(),fdecl->get_name().str());
         printf ("In buildCallGraph(): loop over functions from memory pool: unique = %p = %s name = %s \n",unique,unique->class_name().c_str(),unique->get_name().str());
 #endif
-        if (isSelected(pred)(unique) && hasGraphNodeFor(unique) == NULL)
+        if (isSelected(unique) && hasGraphNodeFor(unique) == NULL)
            {
 #if 0
             printf ("Collect function calls in unique function: unique = %p \n",unique);
 #endif
-            FunctionData fdata(unique, project, &classHierarchy); // computes functions called by unique
+            FunctionData fdata = analyzeFunction(unique); // computes functions called by unique
             callGraphData.push_back(fdata);
-            std::string functionName = unique->get_qualified_name().getString();
-            SgGraphNode *graphNode = new SgGraphNode(functionName);
-            graphNode->set_SgNode(unique);
-            graphNodes[unique] = graphNode;
-            graph->addNode(graphNode);
+            addGraphNodeFor(unique);
           }
          else
           {
 #if 0
             printf ("Function not selected for processing: unique = %p \n",unique);
-            printf ("   --- isSelected(pred)(unique) = %s \n",isSelected(pred)(unique) ? "true" : "false");
+            printf ("   --- isSelected(unique) = %s \n",isSelected(unique) ? "true" : "false");
             printf ("   --- graphNodes.find(unique)==graphNodes.end() = %s \n",graphNodes.find(unique)==graphNodes.end() ? "true" : "false");
 #endif
           }
     }
+    previousCallSiteTargets.clear();                    // call sites of functions that no longer exist
+    previousCallSites.clear();
 
     // Add edges to the graph
     BOOST_FOREACH(FunctionData &currentFunction, callGraphData) {
@@ -250,7 +313,7 @@ CallGraphBuilder::buildCallGraph(Predicate pred)
         ROSE_ASSERT(srcNode != NULL);
         std::vector<SgFunctionDeclaration*> & callees = currentFunction.functionList;
         BOOST_FOREACH(SgFunctionDeclaration * callee, callees) {
-            if (isSelected(pred)(callee)) {
+            if (isSelected(callee)) {
                 SgGraphNode * dstNode = getGraphNodeFor(callee); //getGraphNode here, see function comment
                 ROSE_ASSERT(dstNode != NULL);
                 if (graph->checkIfDirectedGraphEdgeExists(srcNode, dstNode) == false)
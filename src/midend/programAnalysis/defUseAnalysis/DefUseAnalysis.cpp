@@ -11,11 +11,10 @@
 #include "GlobalVarAnalysis.h"
 #include <boost/config.hpp>
 #include <boost/bind.hpp>
+#include <boost/thread.hpp>
 
 
 using namespace std;
-// static counter for the node numbering (for visualization)
-int DefUseAnalysis::sgNodeCounter = 1;
 
 
 /**********************************************************
@@ -507,6 +506,105 @@ bool  DefUseAnalysis::start_traversal_of_functions() {
   return abortme;  
 }
 
+/******************************************
+ * Worker for the parallel traversal: analyzes one function
+ * at a time in private tables that start out with only the
+ * global variable definitions
+ *****************************************/
+void DefUseAnalysis::parallel_traversal_worker(const Rose_STL_Container<SgNode*>& functions,
+                                               std::vector<FunctionTables>& results,
+                                               size_t& nextFunction, boost::mutex& mutex) {
+  DefUseAnalysis local(project);
+  local.globalVarList = globalVarList;
+  while (true) {
+    size_t i;
+    {
+      boost::lock_guard<boost::mutex> lock(mutex);
+      if (nextFunction >= functions.size())
+        return;
+      i = nextFunction++;
+    }
+
+    // this->table holds only the global variables until all workers have finished
+    local.table = table;
+    local.usetable.clear();
+    local.flushHelp();
+
+    SgFunctionDefinition* proc = isSgFunctionDefinition(functions[i]);
+    DefUseAnalysisPF defuse_perfunc(false, &local);
+    bool abortme = false;
+    results[i].source = defuse_perfunc.run(proc, abortme);
+    results[i].aborted = abortme;
+    results[i].nrOfNodesVisited = defuse_perfunc.getNumberOfNodesVisited();
+    results[i].defs.swap(local.table);
+    results[i].uses.swap(local.usetable);
+  }
+}
+
+/**********************************************************
+ *  Add all entries of another table to a table
+ *********************************************************/
+void DefUseAnalysis::mergeAnyTable(tabletype* tabl, const tabletype& other) {
+  for (tabletype::const_iterator i = other.begin(); i != other.end(); ++i) {
+    multitype& multi = (*tabl)[i->first];
+    for (multitype::const_iterator j = i->second.begin(); j != i->second.end(); ++j) {
+      if (find(multi.begin(), multi.end(), *j) == multi.end())
+        multi.push_back(*j);
+    }
+    addID(i->first);
+  }
+}
+
+/******************************************
+ * Traversal over all functions using several threads.
+ * Each function gets its own tables which are merged
+ * in the order of the functions, so the result does not
+ * depend on how the work was scheduled.
+ *****************************************/
+bool  DefUseAnalysis::start_parallel_traversal_of_functions() {
+  if (DEBUG_MODE) 
+    cout << "START: Parallel traversal over Functions" << endl;
+
+  nrOfNodesVisited = 0;
+  dfaFunctions.clear();
+
+  Rose_STL_Container<SgNode*> functions = NodeQuery::querySubTree(project, V_SgFunctionDefinition); 
+  std::vector<FunctionTables> results(functions.size());
+  size_t nextFunction = 0;
+  boost::mutex mutex;
+
+  size_t nWorkers = nThreads > 0 ? nThreads : boost::thread::hardware_concurrency();
+  nWorkers = std::max((size_t)1, std::min(nWorkers, functions.size()));
+  boost::thread_group workers;
+  for (size_t i = 0; i < nWorkers; ++i) {
+    workers.create_thread(boost::bind(&DefUseAnalysis::parallel_traversal_worker, this, boost::cref(functions),
+                                      boost::ref(results), boost::ref(nextFunction), boost::ref(mutex)));
+  }
+  workers.join_all();
+
+  bool abortme = false;
+  for (size_t i = 0; i < results.size(); ++i) {
+    mergeAnyTable(&table, results[i].defs);
+    mergeAnyTable(&usetable, results[i].uses);
+    nrOfNodesVisited += results[i].nrOfNodesVisited;
+    abortme = abortme || results[i].aborted;
+    if (results[i].source.getNode()!=NULL)
+      dfaFunctions.push_back(results[i].source);
+
+    // release memory as we go
+    tabletype().swap(results[i].defs);
+    tabletype().swap(results[i].uses);
+  }
+
+  if (DEBUG_MODE) {
+    dfaToDOT();
+  }
+
+  if (DEBUG_MODE) 
+    cout << "FINISH: Parallel traversal over Functions" << endl;
+  return abortme;  
+}
+
 /******************************************
  * Traversal over one function
  *****************************************/
@@ -560,7 +658,10 @@ int DefUseAnalysis::run() {
   clock_t start = clock();
   find_all_global_variables();
   // traverse through all functions and for each function doWorklist
-  aborted=start_traversal_of_functions();
+  if (!perFunctionTables)
+    aborted=start_traversal_of_functions();
+  else
+    aborted=start_parallel_traversal_of_functions();
   clock_t ends = clock();
   if (DEBUG_MODE)
   {
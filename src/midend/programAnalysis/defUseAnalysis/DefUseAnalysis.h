@@ -18,6 +18,7 @@
 // CH (4/9/2010): Use boost::unordered instead
 #include <boost/unordered_map.hpp>
 #include <boost/unordered_set.hpp>
+#include <boost/thread/mutex.hpp>
 
 #if 0
 #ifdef _MSC_VER
@@ -80,9 +81,23 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   typedef rose_hash::unordered_map< SgNode* , int > convtype;
 #endif
 
+  // def-use tables of one function, computed by a parallel worker
+  struct FunctionTables {
+    tabletype defs;
+    tabletype uses;
+    FilteredCFGNode < IsDFAFilter > source;
+    int nrOfNodesVisited;
+    bool aborted;
+    FunctionTables(): nrOfNodesVisited(0), aborted(false) {}
+  };
+
   // local functions ---------------------
   void find_all_global_variables();
   bool start_traversal_of_functions();
+  bool start_parallel_traversal_of_functions();
+  void parallel_traversal_worker(const Rose_STL_Container<SgNode*>& functions, std::vector<FunctionTables>& results,
+                                 size_t& nextFunction, boost::mutex& mutex);
+  void mergeAnyTable(tabletype* tabl, const tabletype& other);
   bool searchMap(const tabletype* ltable, SgNode* node);
   bool searchVizzMap(SgNode* node);
   std::string getInitName(SgNode* sgNode);
@@ -94,8 +109,12 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   //ideftype idefTable;
   // the helper table for visualization
   convtype vizzhelp;
-  static int sgNodeCounter ;
+  int sgNodeCounter;
   int nrOfNodesVisited;
+  // number of worker threads used by run() for the per-function traversal; 0 means hardware threads
+  size_t nThreads;
+  // whether run() analyzes each function in its own tables (set by setNumberOfThreads) instead of the serial traversal
+  bool perFunctionTables;
 
   // functions to be printed in DFAtoDOT
   std::vector <FilteredCFGNode < IsDFAFilter > > dfaFunctions;
@@ -107,7 +126,7 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
 
  public:
   DefUseAnalysis(SgProject* proj): project(proj), 
-    DEBUG_MODE(false), DEBUG_MODE_EXTRA(false){
+    DEBUG_MODE(false), DEBUG_MODE_EXTRA(false), sgNodeCounter(1), nThreads(1), perFunctionTables(false){
     //visualizationEnabled=true;
     //table.clear();
     //usetable.clear();
@@ -139,6 +158,15 @@ class ROSE_DLL_API DefUseAnalysis : public DFAnalysis, Support {
   // the following one is used for parallel traversal
   int start_traversal_of_one_function(SgFunctionDefinition* proc);
 
+  /** Set the number of threads used by run(); zero means use all hardware threads. Once this is called, every
+   *  function is analyzed independently in its own tables, starting from the definitions of the global variables,
+   *  and the tables are then merged into this object in the order the functions appear in the AST, so the result is
+   *  the same for any number of threads, including one. Unlike the default serial traversal, a function does not see
+   *  definitions of global variables made by the functions analyzed before it; the merged entries of the global
+   *  variables still contain all their definitions. */
+  void setNumberOfThreads(size_t n) { nThreads = n; perFunctionTables = true; }
+  size_t getNumberOfThreads() const { return nThreads; }
+
   // helpers -----------------------------
   bool searchMap(SgNode* node);
   int getDefSize();
@@ -164,9 +164,20 @@ private:
      * the values here cannot be used during interprocedural analysis.  */
     boost::unordered_map<SgNode*, NodeReachingDefTable> ssaLocalDefTable;
 
+    /** If true, the intraprocedural dataflow is run over dense variable numbers instead of VarName keys.
+     * See setUseDenseVarIds. */
+    bool useDenseVarIds;
+
+    /** Number of threads used to propagate definitions within functions. See setNumberOfThreads. */
+    size_t nThreads;
+
+    /** Variables defined in the body of each callee, used by the interprocedural analysis in the dense mode. An entry is
+     * erased whenever new definitions are inserted at a call site inside that function. */
+    boost::unordered_map<SgFunctionDefinition*, std::set<VarName> > calleeDefinedVars;
+
 public:
 
-    StaticSingleAssignment(SgProject* proj) : project(proj)
+    StaticSingleAssignment(SgProject* proj) : project(proj), useDenseVarIds(false), nThreads(1)
     {
     }
 
@@ -190,11 +201,45 @@ public:
         return SgProject::get_verbose() > 1;
     }
 
+    /** Enables or disables the dense variable numbering mode. In this mode the reaching definitions of each function are
+     * propagated using tables indexed by per-function variable numbers and CFG node numbers, and the results are copied into
+     * the regular tables once the dataflow has converged. Query results are identical in both modes; the dense mode avoids
+     * repeatedly comparing VarName vectors and is much faster on large functions. The interprocedural analysis also
+     * remembers the variables defined in each callee instead of traversing the callee once per call site, and detects new
+     * call site definitions by table size instead of comparing copies of the tables. Must be set before calling run(). */
+    void setUseDenseVarIds(bool b)
+    {
+        useDenseVarIds = b;
+    }
+
+    bool getUseDenseVarIds() const
+    {
+        return useDenseVarIds;
+    }
+
+    /** Sets the number of threads used by run() for the per-function dataflow propagation and use table construction;
+     * zero means use all hardware threads. Phi function placement and the interprocedural analysis remain serial. Each
+     * function only touches table entries of its own CFG nodes, so the results do not depend on the number of threads. */
+    void setNumberOfThreads(size_t n)
+    {
+        nThreads = n;
+    }
+
+    size_t getNumberOfThreads() const
+    {
+        return nThreads;
+    }
+
 private:
     /** Once all the local definitions have been inserted in the ssaLocalDefsTable and phi functions have been inserted
      * in the reaching defs table, propagate reaching definitions along the CFG. */
     void runDefUseDataFlow(SgFunctionDefinition* func);
 
+    /** Same as runDefUseDataFlow, but variables are numbered densely within the function and each CFG node's reaching
+     * definitions are kept in flat sorted arrays while iterating. Used when dense variable numbering is enabled.
+     * @param cfgNodesInPostOrder all the CFG nodes of the function, in postorder */
+    void runDefUseDataFlowDense(SgFunctionDefinition* func, const std::vector<FilteredCfgNode>& cfgNodesInPostOrder);
+
     /** Returns true if the variable is implicitly defined at the function entry by the compiler. */
     static bool isBuiltinVar(const VarName& var);
 
@@ -248,6 +293,11 @@ private:
     std::multimap< FilteredCfgNode, std::pair<FilteredCfgNode, FilteredCfgEdge> > insertPhiFunctions(SgFunctionDefinition* function,
             const std::vector<FilteredCfgNode>& cfgNodesInPostOrder);
 
+    /** Propagates definitions and builds the use table for several functions using worker threads. The phi functions
+     * must already have been inserted and the definitions renumbered.
+     * @param functionCfgNodes each function paired with all its CFG nodes in postorder */
+    void runDataflowInParallel(const std::vector<std::pair<SgFunctionDefinition*, std::vector<FilteredCfgNode> > >& functionCfgNodes);
+
     /** Create ReachingDef objects for each local def and insert them in the local def table. */
     void populateLocalDefsTable(SgFunctionDeclaration* function);
 
@@ -309,6 +359,10 @@ private:
     void processOneCallSite(SgExpression* callSite, SgFunctionDeclaration* callee,
             const boost::unordered_set<SgFunctionDefinition*>& processed, ClassHierarchyWrapper* classHierarchy);
 
+    /** Returns the variables defined in the body of a callee, as getOriginalVarsDefinedInSubtree does. In the dense mode the
+     * result is remembered until definitions are inserted at one of the callee's own call sites. */
+    const std::set<VarName>& getVarsDefinedInCallee(SgFunctionDefinition* calleeDef);
+
     /** Given a variable that is in a callee's scope, returns true if the caller can access the same variable, false otherwise.
      * @param callSite either a SgFunctionCallExp or SgConstructorInitializer. */
     static bool isVarAccessibleFromCaller(const VarName& var, SgExpression* callSite, SgFunctionDeclaration* callee);
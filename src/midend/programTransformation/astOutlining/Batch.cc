@@ -0,0 +1,196 @@
+/**
+ *  \file Batch.cc
+ *  \brief Outlining many targets in one pass.
+ *
+ *  Outlining targets one at a time with outline() costs a traversal of
+ *  the enclosing function per target to collect the variables to pass,
+ *  a search of the whole file for the prototype of each outlined
+ *  function, and a fix-up of the whole file after each target, so that
+ *  outlining all the kernels of a file is quadratic in its size.
+ *  outlineBatch() shares these among all targets.
+ */
+#include "sage3basic.h"
+#include "astPostProcessing.h"
+#include <algorithm>
+#include <cstdio>
+#include <iostream>
+#include <set>
+#include <string>
+#include <vector>
+
+#ifndef _MSC_VER
+#include <sys/types.h>
+#include <sys/wait.h>
+#include <unistd.h>
+#endif
+
+#include "Outliner.hh"
+#include "unparser.h"
+
+// =====================================================================
+
+using namespace std;
+
+// =====================================================================
+
+//! Number of ancestors of 's' that are among the 'targets', 0 for a top-level target.
+static size_t
+nestingDepth (const SgStatement* s, const set<const SgNode*>& targets)
+{
+  size_t depth = 0;
+  for (const SgNode* p = s->get_parent (); p != NULL; p = p->get_parent ())
+    if (targets.find (p) != targets.end ())
+      ++depth;
+  return depth;
+}
+
+//! Unparses 'files' with up to 'jobs' child processes, returning the
+//! files that were written. Files written by a child that failed are not
+//! returned, to be unparsed again with the rest of the project.
+static set<SgSourceFile*>
+unparseInParallel (const vector<SgSourceFile*>& files, size_t jobs)
+{
+  set<SgSourceFile*> written;
+#ifndef _MSC_VER
+  if (jobs > files.size ())
+    jobs = files.size ();
+
+  cout.flush ();
+  cerr.flush ();
+  fflush (stdout);
+  fflush (stderr);
+
+  vector<pid_t> children (jobs, -1);
+  for (size_t k = 0; k < jobs; ++k)
+  {
+    pid_t pid = fork ();
+    if (pid == 0)
+    {
+      // child: its own copy of the AST, so the unparser needs no locking
+      for (size_t i = k; i < files.size (); i += jobs)
+        unparseFile (files[i]);
+      cout.flush ();
+      cerr.flush ();
+      fflush (stdout);
+      fflush (stderr);
+      _exit (0);
+    }
+    if (pid < 0)
+      cerr << "Outliner::outlineBatch(): cannot fork, new files are unparsed with the project" << endl;
+    children[k] = pid;
+  }
+
+  for (size_t k = 0; k < jobs; ++k)
+  {
+    if (children[k] < 0)
+      continue;
+    int status = 0;
+    if (waitpid (children[k], &status, 0) != children[k] || !WIFEXITED (status) || WEXITSTATUS (status) != 0)
+    {
+      cerr << "Outliner::outlineBatch(): unparsing new files failed in process " << children[k] << endl;
+      continue;
+    }
+    for (size_t i = k; i < files.size (); i += jobs)
+      written.insert (files[i]);
+  }
+#endif
+  return written;
+}
+
+std::vector<Outliner::Result>
+Outliner::outlineBatch (const std::vector<SgStatement*>& targets, size_t jobs /* = 1 */)
+{
+#ifdef __linux__
+  if (enable_debug)
+    cout<<"Entering "<< __PRETTY_FUNCTION__ <<" with "<<targets.size ()<<" targets"<<endl;
+#endif
+  vector<Result> results (targets.size ());
+
+  // tells insert() not to search the file for the prototypes
+  bool saved_batch_mode = batch_mode;
+  batch_mode = true;
+
+  // names in the order of the targets, as outline() on each would give
+  vector<string> names;
+  for (size_t i = 0; i < targets.size (); ++i)
+    names.push_back (generateFuncName (targets[i]));
+
+  // Targets nested in other targets are outlined one at a time, innermost
+  // first, before the analyses of the other targets are shared.
+  set<const SgNode*> target_set (targets.begin (), targets.end ());
+  vector<size_t> depths (targets.size ());
+  size_t max_depth = 0;
+  for (size_t i = 0; i < targets.size (); ++i)
+  {
+    depths[i] = nestingDepth (targets[i], target_set);
+    max_depth = max (max_depth, depths[i]);
+  }
+  for (size_t depth = max_depth; depth > 0; --depth)
+    for (size_t i = 0; i < targets.size (); ++i)
+      if (depths[i] == depth)
+        results[i] = outline (targets[i], names[i]);
+
+  //---------step 1. preprocess all top-level targets-----------------------
+  vector<size_t> top;
+  vector<SgBasicBlock*> blocks;
+  for (size_t i = 0; i < targets.size (); ++i)
+  {
+    if (depths[i] != 0)
+      continue;
+    top.push_back (i);
+    blocks.push_back (preprocess (targets[i]));
+    ROSE_ASSERT (blocks.back () != NULL);
+  }
+
+  if (preproc_only_)
+  {
+    batch_mode = saved_batch_mode;
+    return results;
+  }
+
+  //---------step 2. variables to pass, one traversal per enclosing function-
+  vector<ASTtools::VarSymSet_t> syms;
+  collectVars (blocks, syms);
+
+  //---------step 3. outline, leaving the fix-ups of the files for later----
+  vector<SgSourceFile*> src_files, new_files;
+  set<SgSourceFile*> seen;
+  for (size_t j = 0; j < blocks.size (); ++j)
+  {
+    SgSourceFile* src_file = TransformationSupport::getSourceFile (blocks[j]);
+    ROSE_ASSERT (src_file != NULL);
+    if (seen.insert (src_file).second)
+      src_files.push_back (src_file);
+
+    Result result = outlineBlock (blocks[j], names[top[j]], syms[j], false);
+    ROSE_ASSERT (result.isValid ());
+    results[top[j]] = result;
+
+    SgSourceFile* new_file = isSgSourceFile (result.file_);
+    if (new_file != NULL && seen.insert (new_file).second)
+      new_files.push_back (new_file);
+  }
+
+  //---------step 4. fix up each file once, in the order of outlineBlock()--
+  for (size_t i = 0; i < new_files.size (); ++i)
+    SageInterface::fixVariableReferences (new_files[i], false);
+  for (size_t i = 0; i < src_files.size (); ++i)
+    AstPostProcessing (src_files[i]);
+  for (size_t i = 0; i < new_files.size (); ++i)
+    AstPostProcessing (new_files[i]);
+
+  //---------step 5. write the new files in parallel------------------------
+  if (jobs > 1 && !new_files.empty ())
+  {
+    set<SgSourceFile*> written = unparseInParallel (new_files, jobs);
+    for (set<SgSourceFile*>::iterator i = written.begin (); i != written.end (); ++i)
+      (*i)->set_skip_unparse (true);
+    if (enable_debug)
+      cout<<"Outliner::outlineBatch(): "<<written.size ()<<" of "<<new_files.size ()<<" new files written with "<<jobs<<" processes"<<endl;
+  }
+
+  batch_mode = saved_batch_mode;
+  return results;
+}
+
+// eof
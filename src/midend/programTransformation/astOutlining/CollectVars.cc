@@ -8,6 +8,7 @@
 #include "sage3basic.h"
 #include <iostream>
 #include <list>
+#include <map>
 #include <string>
 
 
@@ -40,9 +41,10 @@ dump (const ASTtools::VarSymSet_t& V, const std::string& tag)
 //  * Q: declared within the enclosing function surrounding 's'
 //       but not globally declared beyond the function surrounding 's'  (global variables should not be passed if the outlined function  is put within the same file )  
 //
-void
-Outliner::collectVars (const SgStatement* s, 
-                       ASTtools::VarSymSet_t& syms) // return the symbols(variables) that need to be passed into the outlined function 
+static void
+collectVars (const SgStatement* s,
+             const ASTtools::VarSymSet_t* Q_in, // Q computed by the caller, or NULL
+             ASTtools::VarSymSet_t& syms)
 {
   // Determine the function definition surrounding 's'. The enclosing function of 's'
   const SgFunctionDefinition* outer_func_s = ASTtools::findFirstFuncDef (s);
@@ -79,9 +81,11 @@ Outliner::collectVars (const SgStatement* s,
   else
   {
     // Q = {symbols defined within the function surrounding 's' that are visible at 's'}, including function parameters
-    ASTtools::VarSymSet_t Q;
-    ASTtools::collectLocalVisibleVarSyms (outer_func_s->get_declaration (),
-        s, Q);
+    ASTtools::VarSymSet_t Q_local;
+    if (Q_in == NULL)
+      ASTtools::collectLocalVisibleVarSyms (outer_func_s->get_declaration (),
+          s, Q_local);
+    const ASTtools::VarSymSet_t& Q = Q_in ? *Q_in : Q_local;
     dump (Q, "Q (variables defined within the function surrounding s that are visible at s) = ");
 
     // (U - L) \cap Q = {variables that need to be passed as parameters to the outlined function}
@@ -94,4 +98,47 @@ Outliner::collectVars (const SgStatement* s,
   }
 }
 
+void
+Outliner::collectVars (const SgStatement* s, 
+                       ASTtools::VarSymSet_t& syms) // return the symbols(variables) that need to be passed into the outlined function 
+{
+  ::collectVars (s, NULL, syms);
+}
+
+//! Collect the variables to be passed for several targets at once.
+//  Q is the part that grows with the size of the enclosing function: it is
+//  computed in one traversal per enclosing function for all of its targets.
+void
+Outliner::collectVars (const std::vector<SgBasicBlock*>& targets,
+                       std::vector<ASTtools::VarSymSet_t>& syms)
+{
+  syms.clear ();
+  syms.resize (targets.size ());
+
+  // targets grouped by their enclosing function
+  typedef std::map<const SgFunctionDefinition*, std::vector<size_t> > FuncTargets_t;
+  FuncTargets_t func_targets;
+  for (size_t i = 0; i < targets.size (); ++i)
+  {
+    const SgFunctionDefinition* outer_func_s = ASTtools::findFirstFuncDef (targets[i]);
+    ROSE_ASSERT (outer_func_s);
+    func_targets[outer_func_s].push_back (i);
+  }
+
+  for (FuncTargets_t::const_iterator f = func_targets.begin (); f != func_targets.end (); ++f)
+  {
+    const std::vector<size_t>& indices = f->second;
+    std::vector<ASTtools::VarSymSet_t> Q;
+    if (!Outliner::useNewFile)
+    {
+      std::vector<const SgStatement*> stmts;
+      for (size_t j = 0; j < indices.size (); ++j)
+        stmts.push_back (targets[indices[j]]);
+      ASTtools::collectLocalVisibleVarSyms (f->first->get_declaration (), stmts, Q);
+    }
+    for (size_t j = 0; j < indices.size (); ++j)
+      ::collectVars (targets[indices[j]], Q.empty () ? NULL : &Q[j], syms[indices[j]]);
+  }
+}
+
 // eof
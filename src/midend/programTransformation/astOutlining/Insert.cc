@@ -305,13 +305,19 @@ insertGlobalPrototype (SgFunctionDeclaration* def,
      if (def && scope)
         {
        // DQ (3/3/2009): Why does this code use try .. catch blocks (exception handling)?
-          GlobalProtoInserter ins (def, scope);
-          try
+       // The only non-global declarations of a new outlined function are the friend declarations in
+       // friendFunctionPrototypeList, so a batch (outlineBatch()) skips the search of the whole file
+       // and uses the first of them below.
+          if (!Outliner::batch_mode)
              {
-               ins.traverse (scope, preorder);
+               GlobalProtoInserter ins (def, scope);
+               try
+                  {
+                    ins.traverse (scope, preorder);
+                  }
+               catch (string & s) { ROSE_ASSERT (s == "done"); }
+               prototype = ins.getProto();
              }
-          catch (string & s) { ROSE_ASSERT (s == "done"); }
-          prototype = ins.getProto();
 
           if (!prototype && default_target) // No declaration found
              {
@@ -39,6 +39,8 @@ namespace Outliner {
   bool enable_template=false; // Outlining code blocks inside C++ templates
   bool select_omp_loop = false;  // Find OpenMP for loops and outline them. This is used for testing purposes.
   std::string output_path=""; // default output path is the original file's directory
+  bool batch_mode = false; // outline all targets of outlineAll() with outlineBatch()
+  size_t batch_jobs = 1; // processes writing the new files of a batch
   std::vector<std::string> handles; //  abstract handles of outlining targets, given by command line option -rose:outline:abstract_handle for each
 
 // DQ (3/19/2019): Suppress the output of the #include "autotuning_lib.h" since some tools will want to define there own supporting libraries and header files.
@@ -248,6 +250,15 @@ Outliner::commandLineSwitches() {
                     .argument("name", anyParser(output_path))
                     .doc("Use a custom output path."));
 
+    switches.insert(Switch("batch")
+                    .intrinsicValue(true, batch_mode)
+                    .doc("Outline all targets in one batch, sharing the analyses of their enclosing functions and files."));
+
+    switches.insert(Switch("batch_jobs")
+                    .argument("n", nonNegativeIntegerParser(batch_jobs))
+                    .doc("Number of processes writing the new source files of a batch in parallel. This switch is only "
+                         "honored if @s{batch} and @s{new_file} were specified."));
+
     switches.insert(Switch("enable_liveness")
                     .intrinsicValue(true, enable_liveness)
                     .doc("This switch is only honored if @s{temp_variable} was specified."));
@@ -293,6 +304,9 @@ Outliner::validateSettings()
     }
 
     //------------ handle side effects of options-----------
+    if (batch_jobs == 0) {
+        batch_jobs = 1;
+    }
     if (useStructureWrapper) {
         useParameterWrapper = true;
     }
@@ -426,6 +440,26 @@ void Outliner::commandLineProcessing(std::vector<std::string> &argvList)
 //  else  //reset to NULL if useNewFile is not true
 //    output_path="";
 
+  if (CommandlineProcessing::isOption (argvList,"-rose:outline:","batch",true))
+  {
+    if (enable_debug)
+      cout<<"Outlining all targets in one batch ..."<<endl;
+    batch_mode = true;
+  }
+
+  int jobs = 0;
+  if (CommandlineProcessing::isOptionWithParameter (argvList,"-rose:outline:","batch_jobs",jobs, true))
+  {
+    if (jobs < 1)
+    {
+      cerr<<"-rose:outline:batch_jobs needs a positive number of processes"<<endl;
+      ROSE_ASSERT(false);
+    }
+    batch_jobs = jobs;
+    if (enable_debug)
+      cout<<"Writing new files of a batch with "<<batch_jobs<<" processes"<<endl;
+  }
+
   if (CommandlineProcessing::isOption (argvList,"-rose:outline:","select_omp_loop",true))
   {
     if (enable_debug)
@@ -465,6 +499,8 @@ void Outliner::commandLineProcessing(std::vector<std::string> &argvList)
     cout<<"\t-rose:outline:enable_template                  support outlining code blocks inside C++ templates (experimental)"<<endl;
     cout<<"\t-rose:outline:enable_debug                     run outliner in a debugging mode"<<endl;
     cout<<"\t-rose:outline:select_omp_loop                  select OpenMP for loops for outlining, used for testing purpose"<<endl;
+    cout<<"\t-rose:outline:batch                            outline all targets in one batch, sharing the analyses of their enclosing functions and files"<<endl;
+    cout<<"\t-rose:outline:batch_jobs N                     write the new files of a batch with N processes in parallel, if requested by new_file"<<endl;
     cout <<"---------------------------------------------------------------"<<endl;
   }
 
@@ -577,8 +613,12 @@ Outliner::DeferedTransformation & Outliner::DeferedTransformation::operator= (co
      printf ("Inside of Outliner::DeferedTransformation::operator= (const DeferedTransformation& X) \n");
 #endif
 
+     class_definition       = X.class_definition;
+     target_class_member    = X.target_class_member;
+     new_function_prototype = X.new_function_prototype;
      targetFriends = X.targetFriends;
      targetClasses = X.targetClasses;
+     return *this;
    }
 
 
@@ -77,6 +77,9 @@ namespace Outliner
   
   ROSE_DLL_API extern std::string output_path; // where to save the new file containing the outlined function
 
+  ROSE_DLL_API extern bool batch_mode; // Outline all targets found by outlineAll() in one batch, see outlineBatch(). Activated by -rose:outline:batch. Also set while outlineBatch() runs.
+  ROSE_DLL_API extern size_t batch_jobs; // Number of processes writing the new files of a batch in parallel (new_file only). Set by -rose:outline:batch_jobs
+
 // DQ (3/19/2019): Suppress the output of the #include "autotuning_lib.h" since some tools will want to define there own supporting libraries and header files.
   ROSE_DLL_API extern bool suppress_autotuning_header; // when generating the new file to store outlined function, suppress output of #include "autotuning_lib.h".
 
@@ -226,6 +229,27 @@ ROSE_DLL_API Sawyer::CommandLine::SwitchGroup commandLineSwitches();
    */
   ROSE_DLL_API size_t outlineAll (SgProject *);
 
+  //! Outlines many statements in one pass.
+  /*!
+   *  Equivalent to calling outline() on each of the targets, but the
+   *  work that outline() repeats over the whole enclosing function or
+   *  file for every target is done once for all of them:
+   *  - all targets are preprocessed first, then the variables to be
+   *    passed are collected with one traversal per enclosing function;
+   *  - the prototype of each outlined function is inserted directly
+   *    before its enclosing function, without searching the file for
+   *    an existing one;
+   *  - each modified file is fixed up (AstPostProcessing()) once at
+   *    the end instead of after each target;
+   *  - with useNewFile, the new files are unparsed by up to 'jobs'
+   *    processes in parallel, and skipped by the project's unparser.
+   *
+   *  Targets nested in other targets are outlined first, one at a time.
+   *
+   *  \returns The results, in the order of 'targets'.
+   */
+  ROSE_DLL_API std::vector<Result> outlineBatch (const std::vector<SgStatement*>& targets, size_t jobs = 1);
+
   /**
    * \name The following routines, intended for debugging, mirror the
    * core outlining routines above, but only run the outlining
@@ -247,6 +271,17 @@ ROSE_DLL_API Sawyer::CommandLine::SwitchGroup commandLineSwitches();
      */
     Result outlineBlock (SgBasicBlock* b, const std::string& name);
 
+    /*!
+     *  \brief Outlines the given basic block into a function named
+     *  'name', passing the variables 'syms' computed by collectVars().
+     *
+     *  Without post_process, the fix-ups of the enclosing files
+     *  (AstPostProcessing() and variable references in a new file)
+     *  are left to the caller, to be done once for many blocks.
+     */
+    Result outlineBlock (SgBasicBlock* b, const std::string& name,
+                         const ASTtools::VarSymSet_t& syms, bool post_process = true);
+
     /*!
      *  \brief Computes the set of variables in 's' that need to be
      *  passed to the outlined routine (semantically equivalent to shared variables in OpenMP) 
@@ -259,6 +294,9 @@ ROSE_DLL_API Sawyer::CommandLine::SwitchGroup commandLineSwitches();
      *  handle their special variables in advance. 
      */
     void collectVars (const SgStatement* s, ASTtools::VarSymSet_t& syms);
+
+    //! collectVars() for several targets, sharing the traversal of their enclosing functions. syms[i] is for targets[i].
+    void collectVars (const std::vector<SgBasicBlock*>& targets, std::vector<ASTtools::VarSymSet_t>& syms);
     //void collectVars (const SgStatement* s, ASTtools::VarSymSet_t& syms, ASTtools::VarSymSet_t& private_syms);
 
     /*!\brief Generate a new source file under the same SgProject as
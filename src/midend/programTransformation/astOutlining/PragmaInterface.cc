@@ -341,6 +341,47 @@ collectAbstractHandles(SgProject* proj,  TargetList_t& targets)
 return 0;
 }
 
+//! Outlines all targets with Outliner::outlineBatch(), returning the number of valid results.
+static size_t
+outlineTargetsInBatch (const TargetList_t& targets)
+{
+  vector<SgStatement*> stmts (targets.begin (), targets.end ());
+  vector<Outliner::Result> results = Outliner::outlineBatch (stmts, Outliner::batch_jobs);
+  size_t count = 0;
+  for (size_t i = 0; i < results.size (); ++i)
+    if (results[i].isValid ())
+      ++count;
+  return count;
+}
+
+//! Outlines the statements following all pragmas with Outliner::outlineBatch(),
+//! then removes each pragma as Outliner::outline(SgPragmaDeclaration*) does.
+static size_t
+outlinePragmasInBatch (const PragmaList_t& pragmas)
+{
+  vector<SgStatement*> targets;
+  for (PragmaList_t::const_iterator i = pragmas.begin (); i != pragmas.end (); ++i)
+    targets.push_back (processPragma (*i));
+  vector<Outliner::Result> results = Outliner::outlineBatch (targets, Outliner::batch_jobs);
+  if (Outliner::preproc_only_)
+    return 0;
+
+  size_t count = 0;
+  for (size_t i = 0; i < results.size (); ++i)
+  {
+    ROSE_ASSERT (results[i].isValid());
+    ASTtools::moveBeforePreprocInfo (pragmas[i], results[i].call_);
+    ASTtools::moveAfterPreprocInfo (pragmas[i], results[i].call_);
+#ifndef _MSC_VER
+    LowLevelRewrite::remove (pragmas[i]);
+#else
+    ROSE_ASSERT(false);
+#endif
+    ++count;
+  }
+  return count;
+}
+
 //-------------------top level drivers----------------------------------------
 size_t
 Outliner::outlineAll (SgProject* project)
@@ -351,6 +392,9 @@ Outliner::outlineAll (SgProject* project)
   if (Outliner::handles.size()>0)
   {
     collectAbstractHandles(project,targets);
+    if (batch_mode)
+      num_outlined += outlineTargetsInBatch (targets);
+    else
     for (TargetList_t::iterator i = targets.begin ();
         i != targets.end (); ++i)
       if (outline(*i).isValid())
@@ -361,6 +405,9 @@ Outliner::outlineAll (SgProject* project)
   { // Search for the special source comments for Fortran input
     if (collectFortranTarget(project, targets))
     {
+      if (batch_mode)
+        num_outlined += outlineTargetsInBatch (targets);
+      else
       for (TargetList_t::iterator i = targets.begin ();
           i != targets.end (); ++i)
         if (outline(*i).isValid())
@@ -372,6 +419,9 @@ Outliner::outlineAll (SgProject* project)
     PragmaList_t pragmas;
     if (collectPragmas (project, pragmas))
     {
+      if (batch_mode)
+        num_outlined += outlinePragmasInBatch (pragmas);
+      else
       for (PragmaList_t::iterator i = pragmas.begin (); i != pragmas.end (); ++i)
       {
         if (outline (*i).isValid ())
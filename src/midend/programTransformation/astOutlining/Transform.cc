@@ -215,6 +215,17 @@ Outliner::outlineBlock (SgBasicBlock* s, const string& func_name_str)
   printf ("Inside of Outliner::outlineBlock() \n");
 #endif
 
+  // Determine variables to be passed to outlined routine.
+  ASTtools::VarSymSet_t syms;
+  collectVars (s, syms);
+  return outlineBlock (s, func_name_str, syms);
+}
+
+Outliner::Result
+Outliner::outlineBlock (SgBasicBlock* s, const string& func_name_str,
+                        const ASTtools::VarSymSet_t& passed_syms, bool post_process /* = true */)
+{
+
   //---------step 1. Preparations-----------------------------------
   //new file, cut preprocessing information, collect variables
   // Generate a new source file for the outlined function, if requested
@@ -232,11 +243,10 @@ Outliner::outlineBlock (SgBasicBlock* s, const string& func_name_str)
   ASTtools::cutPreprocInfo (s, PreprocessingInfo::before, ppi_before);
   ASTtools::cutPreprocInfo (s, PreprocessingInfo::after, ppi_after);
 
-  // Determine variables to be passed to outlined routine.
+  // Variables to be passed to outlined routine, collected by the caller.
   // ----------------------------------------------------------
   // Also collect symbols which must use pointer dereferencing if replaced during outlining
-  ASTtools::VarSymSet_t syms, pdSyms;
-  collectVars (s, syms);
+  ASTtools::VarSymSet_t syms (passed_syms), pdSyms;
   for (ASTtools::VarSymSet_t::iterator it = syms.begin(); it != syms.end(); it++ )
     ROSE_ASSERT (*it!=NULL);
 
@@ -550,7 +560,7 @@ Outliner::outlineBlock (SgBasicBlock* s, const string& func_name_str)
 
   //ROSE_ASSERT (wrapper_exp->get_symbol()->get_declaration() != NULL);
   //-----------handle dependent declarations, headers if new file is generated-------------
-  if (new_file)
+  if (new_file && post_process)
   {
     // Liao, 2019/8/14. We disable unused symbol clean up for now. 
     // Searching for all symbols then check if they are used within a new file. 
@@ -621,6 +631,10 @@ Outliner::outlineBlock (SgBasicBlock* s, const string& func_name_str)
      printf ("DONE: In Outliner::outlineBlock(): Generate the dot output of the SAGE III AST \n");
 #endif
 
+  // A batch of targets (outlineBatch()) fixes up each file once after all of them are outlined
+  if (!post_process)
+     return Result (func, func_call, new_file, headerFileTransformation);
+
 #if 1
   // DQ (2/7/2020): Disable call to AstPostProcessing so that I can call it in tool_G.C as part of debugging).
   // DQ (2/26/2009): Moved (here) to as late as possible so that all transformations are complete before running AstPostProcessing()
@@ -7,6 +7,7 @@
 // tps (01/14/2010) : Switching from rose.h to sage3.
 #include "sage3basic.h"
 #include <algorithm>
+#include <map>
 
 #include "VarSym.hh"
 
@@ -390,6 +391,68 @@ ASTtools::collectLocalVisibleVarSyms (const SgStatement* root,
     }
 }
 
+void
+ASTtools::collectLocalVisibleVarSyms (const SgStatement* root,
+                                      const std::vector<const SgStatement*>& targets,
+                                      std::vector<VarSymSet_t>& syms)
+{
+  //! Traversal taking a copy of the symbols collected so far at each
+  //! target, stopping once the last target is met.
+  class Collector : public AstSimpleProcessing
+  {
+  public:
+    Collector (const std::vector<const SgStatement*>& targets, std::vector<VarSymSet_t>& syms)
+      : syms_ (syms)
+    {
+      for (size_t i = 0; i < targets.size (); ++i)
+        targets_.insert (make_pair (targets[i], i));
+      remaining_ = targets_.size ();
+    }
+
+    virtual void visit (SgNode* n)
+    {
+      std::map<const SgStatement*, size_t>::const_iterator t = targets_.find (isSgStatement (n));
+      if (t != targets_.end ())
+        {
+          syms_[t->second] = collected_;
+          if (--remaining_ == 0)
+            throw string ("done");
+        }
+      getVarSyms (n, &collected_);
+      SgScopeStatement* scope = isSgScopeStatement(n);
+      if(scope) {
+        SgSymbolTable * table = scope->get_symbol_table();
+        std::set<SgNode*> nodeset = table->get_symbolSet();
+        for (std::set<SgNode*>::iterator i=nodeset.begin();i!=nodeset.end();i++)
+        {
+            SgVariableSymbol* varsymbol = isSgVariableSymbol (*i);
+            if(varsymbol) getVarSyms (varsymbol, &collected_);
+        }
+      }
+    }
+
+  private:
+    std::map<const SgStatement*, size_t> targets_; //!< Target to its index in syms_.
+    std::vector<VarSymSet_t>& syms_; //!< Containers in which to copy the symbols.
+    VarSymSet_t collected_; //!< Symbols met so far.
+    size_t remaining_; //!< Number of targets not met yet.
+  };
+
+  syms.clear ();
+  syms.resize (targets.size ());
+  if (targets.empty ())
+    return;
+  Collector collector (targets, syms);
+  try
+    {
+      collector.traverse (const_cast<SgStatement *> (root), preorder);
+    }
+  catch (string& stopped_early)
+    {
+      ROSE_ASSERT (stopped_early == "done");
+    }
+}
+
 //! Collect variable reference a using addresses within s, 
 //including &a expression and foo(a) when type2 foo(Type& parameter) in C++
 void ASTtools::collectVarRefsUsingAddress(const SgStatement* s, std::set<SgVarRefExp* >& varSetB)
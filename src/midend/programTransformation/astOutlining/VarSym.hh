@@ -10,6 +10,7 @@
 #define INC_ASTTOOLS_VARSYM_HH
 
 #include <set>
+#include <vector>
 #include "Outliner.hh"
 
 class SgVariableSymbol;
@@ -36,6 +37,16 @@ namespace ASTtools
                                    const SgStatement* target,
                                    VarSymSet_t& syms);
 
+  /*!
+   *  Same as collectLocalVisibleVarSyms() for several targets under
+   *  'root' at once, in a single traversal; syms[i] receives the var
+   *  syms for targets[i].
+   */
+  ROSE_DLL_API
+  void collectLocalVisibleVarSyms (const SgStatement* root,
+                                   const std::vector<const SgStatement*>& targets,
+                                   std::vector<VarSymSet_t>& syms);
+
   //! Convert a variable symbol set to a string-friendly form for debugging.
   ROSE_DLL_API std::string toString (const VarSymSet_t& syms);
 
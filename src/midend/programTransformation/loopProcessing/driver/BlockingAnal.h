@@ -83,6 +83,28 @@ class AllLoopReuseBlocking : public LoopBlocking
                         const CompSliceDepGraphNode::FullNestInfo& nestInfo);
 };
 
+/* tile sizes chosen by the cache model (see CacheModel.h) */
+class CacheModelBlocking : public AllLoopReuseBlocking
+{
+ public:
+  virtual LoopTransformOptions::OptType GetOptimizationType() { return LoopTransformOptions::LOOP_NEST_OPT; }
+  /* return the innermost slice after blocking */
+  virtual const CompSlice* 
+  SetBlocking( CompSliceLocalityRegistry *anal, 
+                        const CompSliceDepGraphNode::FullNestInfo& nestInfo);
+};
+
+/* tile sizes tuned empirically (see EmpiricalTuning.h) */
+class EmpiricalBlocking : public AllLoopReuseBlocking
+{
+ public:
+  virtual LoopTransformOptions::OptType GetOptimizationType() { return LoopTransformOptions::LOOP_NEST_OPT; }
+  /* return the innermost slice after blocking */
+  virtual const CompSlice* 
+  SetBlocking( CompSliceLocalityRegistry *anal, 
+                        const CompSliceDepGraphNode::FullNestInfo& nestInfo);
+};
+
 class ParameterizeBlocking : public AllLoopReuseBlocking
 {
  protected:
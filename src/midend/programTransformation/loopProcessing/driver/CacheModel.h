@@ -0,0 +1,75 @@
+#ifndef CACHE_MODEL_H
+#define CACHE_MODEL_H
+
+#include <string>
+#include <vector>
+
+class CompSlice;
+class CompSliceNest;
+
+/* A simple capacity model of the memory hierarchy used to choose tile
+   sizes, the loop nesting order and which loop nests to fuse.
+   The footprint of a loop nest is estimated from the stride of each array
+   reference (see ReferenceStride in ReuseAnalysis.h) with respect to each
+   loop of the nest: a reference touches one cache line every
+   linesize/stride iterations of its unit-stride loop and a new line at
+   each iteration of any other loop it varies with. References to the same
+   array with identical strides are counted once. */
+struct CacheLevel {
+  unsigned size, linesize, assoc;
+  CacheLevel(unsigned s = 0, unsigned l = 64, unsigned a = 8)
+    : size(s), linesize(l), assoc(a) {}
+  /* the capacity a loop nest may use without suffering conflict misses:
+     one way of a set-associative cache is left for the other data. */
+  unsigned EffectiveSize() const
+    { return (assoc > 1)? size / assoc * (assoc - 1) : size / 2; }
+};
+
+class CacheModel
+{
+  std::vector<CacheLevel> levels;
+  unsigned minTile, maxTile;
+ public:
+  CacheModel();
+
+  /* spec is a comma separated list of levels from the innermost outward,
+     each being size[:linesize[:assoc]]; sizes may end with K or M.
+     returns false (and keeps the current hierarchy) if spec is malformed. */
+  bool SetHierarchy( const std::string& spec);
+  /* sets the line size of every level (as -clsize does) */
+  void SetCacheLineSize( unsigned linesize);
+  std::string toString() const;
+  unsigned NumberOfLevels() const { return levels.size(); }
+  const CacheLevel& Level( unsigned i) const { return levels[i]; }
+  unsigned GetCacheLineSize() const { return levels[0].linesize; }
+
+  /* the number of iterations of the loops of slice, or def if unknown */
+  static unsigned TripCount( const CompSlice* slice, unsigned def = 100);
+
+  /* cache lines touched by one iteration of slice, summed over the array
+     references of its statements; a small value means good spatial and
+     temporal reuse when slice is placed innermost. */
+  float LinesPerIteration( const CompSlice* slice) const;
+
+  /* bytes touched by one iteration of slice first-1 of n, i.e. by slices
+     first .. n.NumberOfEntries()-1 each running trips[i] iterations. */
+  float Footprint( const CompSliceNest& n, int first,
+                   const std::vector<unsigned>& trips) const;
+  /* the same with every loop running all its iterations */
+  float Footprint( const CompSliceNest& n, int first) const;
+
+  /* sets the tile size of each slice in n (1 if the slice should not be
+     tiled), tiling only the slices from reuseLevel inward.
+     tiles are the largest power of two between minTile and maxTile such
+     that the tiled footprint fits in the innermost cache level possible.
+     returns false if no tiling is profitable. */
+  bool ChooseTileSizes( const CompSliceNest& n, int reuseLevel,
+                        std::vector<unsigned>& tiles) const;
+
+  /* whether the data touched by one iteration of slices j of n1 and k of n2
+     fits together in the outermost cache level */
+  bool FitsAfterFusion( const CompSliceNest& n1, int j,
+                        const CompSliceNest& n2, int k) const;
+};
+
+#endif
@@ -0,0 +1,64 @@
+#ifndef EMPIRICAL_TUNING_H
+#define EMPIRICAL_TUNING_H
+
+#include <map>
+#include <set>
+#include <string>
+#include <vector>
+
+class CompSliceNest;
+
+/* Closed-loop empirical tuning of tile sizes, without POET.
+   Each loop nest is identified by a hash of its loops and statements. The
+   tile size used for a nest (see EmpiricalBlocking in BlockingAnal.h) is the
+   one being tried while tuning, else the best one recorded in a local
+   database, else the default block size.
+   Tune() tries each candidate tile size of each nest not yet in the database:
+   the transformed program is generated in a child process, then the harness
+   command is run to build and time it; the results are saved to the
+   database so that later runs reuse the decisions without measuring again. */
+
+/* generates one variant of the program, e.g. transforms and unparses it */
+class TuningVariant
+{
+ public:
+  virtual ~TuningVariant() {}
+  virtual void operator()() = 0;
+};
+
+class EmpiricalTuning
+{
+  std::string dbName, harness;
+  std::vector<unsigned> sizes;
+  /* nest hash -> tile size -> best seconds measured */
+  std::map<std::string, std::map<unsigned,double> > results;
+  std::map<std::string, unsigned> trying;
+  /* the nests whose tile size was asked for, each once */
+  std::set<std::string> seen;
+  bool loaded;
+
+  void LoadDatabase();
+  void SaveDatabase() const;
+  /* generates the variant in a child process and times the harness on it;
+     returns false if either fails. nests: the nests seen in the variant */
+  bool RunVariant(TuningVariant& variant, double& seconds,
+                  std::vector<std::string>* nests = 0);
+ public:
+  EmpiricalTuning();
+
+  void SetDatabase(const std::string& name) { dbName = name; loaded = false; }
+  void SetHarness(const std::string& cmd) { harness = cmd; }
+  /* comma separated list of tile sizes; 1 means no tiling */
+  bool SetCandidateSizes(const std::string& list);
+  bool HasHarness() const { return harness != ""; }
+
+  static std::string NestHash(const CompSliceNest& n);
+  /* the tile size to use for the nest with the given hash; def if none */
+  unsigned GetTileSize(const std::string& hash, unsigned def);
+
+  /* tunes the nests of the program generated by variant; returns false if
+     the program could not be generated or measured with the current sizes */
+  bool Tune(TuningVariant& variant);
+};
+
+#endif
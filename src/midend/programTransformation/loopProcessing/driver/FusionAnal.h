@@ -50,6 +50,15 @@ class AnyReuseFusionAnal : public LoopFusionAnal
   virtual LoopTransformOptions::OptType GetOptimizationType() { return LoopTransformOptions::MULTI_LEVEL_OPT; }
 };
 
+/* fuses for reuse as AnyReuseFusionAnal, but only if the data of the fused
+   loop bodies still fit in the outermost cache level (see CacheModel.h) */
+class CacheModelFusionAnal : public AnyReuseFusionAnal
+{
+ public:
+  FusionInfo operator()( CompSliceLocalityRegistry *anal, CompSliceNest& n1, CompSliceNest& n2,
+                                int j, int k, const DepInfo& e);
+};
+
 class BetterReuseFusionAnal : public LoopFusionAnal
 {
   int index;
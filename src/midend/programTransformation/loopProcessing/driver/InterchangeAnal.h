@@ -37,4 +37,14 @@ class ArrangeReuseOrder : public ArrangeNestingOrder
    virtual LoopTransformOptions::OptType GetOptimizationType() { return LoopTransformOptions::PAR_LOOP_OPT; }
 };
 
+/* places innermost the slices touching the fewest cache lines per iteration,
+   as estimated by the cache model (see CacheModel.h) */
+class ArrangeCacheModelOrder : public ArrangeNestingOrder
+{
+  protected:
+    virtual void SetNestingWeight(CompSliceLocalityRegistry *anal, CompSliceNest& g, float *weightvec);
+  public:
+   virtual LoopTransformOptions::OptType GetOptimizationType() { return LoopTransformOptions::LOOP_NEST_OPT; }
+};
+
 #endif
@@ -15,6 +15,8 @@ class LoopPar;
 class CopyArrayOperator;
 class AstNodePtr;
 class LoopTransformInterface;
+class CacheModel;
+class EmpiricalTuning;
 class LoopTransformOptions 
 {
  public:
@@ -39,6 +41,8 @@ class LoopTransformOptions
   LoopBlocking *bkOp;
   LoopPar * parOp;
   CopyArrayOperator* cpOp;
+  CacheModel* cacheModel;
+  EmpiricalTuning* tuning;
   unsigned cacheline, reuseDist, splitlimit, defaultblocksize, parblocksize;
   LoopTransformOptions();
   virtual ~LoopTransformOptions();
@@ -55,6 +59,8 @@ class LoopTransformOptions
   ArrangeNestingOrder* GetInterchangeSel() const  { return icOp; }
   LoopNestFusion* GetFusionSel() const { return fsOp; }
   unsigned GetCacheLineSize() const { return cacheline; }
+  CacheModel* GetCacheModel() const { return cacheModel; }
+  EmpiricalTuning* GetEmpiricalTuning() const { return tuning; }
   unsigned GetReuseDistance() const { return reuseDist; }
   unsigned GetTransAnalSplitLimit() const { return splitlimit; }
   unsigned GetDefaultBlockSize() const { return defaultblocksize; }
@@ -22,6 +22,7 @@ extern "C" {
 extern double xomp_time_stamp(void);
 extern int env_region_instr_val; // save the environment variable value for instrumentation support
 //e.g. export XOMP_REGION_INSTR=0|1
+// Per-thread region times, barrier waits and hardware counters: export XOMP_REGION_PROFILE=<file>, see xomp_profile.h
 
 //enum omp_rtl_enum {
 //  e_gomp,
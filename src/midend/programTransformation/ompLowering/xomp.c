@@ -1,7 +1,15 @@
 #include "rose_config.h"
 #include "libxomp.h"
+#include "xomp_profile.h"
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY 
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+
+// Native runtime header, see xomp_native.h
+#include "xomp_native.h"
+// The native runtime has the highest precedence if more than one runtime library is specified
+#undef USE_ROSE_OMNI_OPENMP_SUPPORT
+
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 
 // GOMP header
 #include "libgomp_g.h"
@@ -17,6 +25,27 @@
 extern int omp_get_thread_num(void);
 extern int omp_get_num_threads(void);
 
+#ifdef USE_ROSE_NATIVE_XOMP_RUNTIME
+// The native runtime owns the thread team, so it also answers OpenMP queries from the translated code
+extern int omp_get_max_threads(void);
+extern void omp_set_num_threads(int n);
+extern int omp_in_parallel(void);
+extern int omp_get_num_procs(void);
+extern double omp_get_wtime(void);
+extern double omp_get_wtick(void);
+// Lock arguments are pointers to omp_lock_t or omp_nest_lock_t, which are declared in omp.h
+extern void omp_init_lock(void *lock);
+extern void omp_destroy_lock(void *lock);
+extern void omp_set_lock(void *lock);
+extern void omp_unset_lock(void *lock);
+extern int omp_test_lock(void *lock);
+extern void omp_init_nest_lock(void *lock);
+extern void omp_destroy_nest_lock(void *lock);
+extern void omp_set_nest_lock(void *lock);
+extern void omp_unset_nest_lock(void *lock);
+extern int omp_test_nest_lock(void *lock);
+#endif
+
 #include <stdlib.h> // for getenv(), malloc(), etc
 #include <stdio.h> // for getenv(), file
 #include <assert.h>
@@ -26,6 +55,7 @@ extern int omp_get_num_threads(void);
 /* Timing support, Liao 2/15/2013 */
 #include <sys/time.h>
 #include <time.h> /*current time*/
+#include <unistd.h> // for sysconf()
 
 int env_region_instr_val = 0;
 FILE* fp = 0;
@@ -101,6 +131,82 @@ static enum omp_rtl_enum get_rtl_type()
 }
 
 #endif
+#ifdef USE_ROSE_NATIVE_XOMP_RUNTIME
+int omp_get_thread_num(void)
+{
+  return xomp_native_thread_num();
+}
+int omp_get_num_threads(void)
+{
+  return xomp_native_num_threads();
+}
+int omp_get_max_threads(void)
+{
+  return xomp_native_max_threads();
+}
+void omp_set_num_threads(int n)
+{
+  xomp_native_set_num_threads(n);
+}
+int omp_in_parallel(void)
+{
+  return xomp_native_in_parallel();
+}
+int omp_get_num_procs(void)
+{
+  long n = sysconf(_SC_NPROCESSORS_ONLN);
+  return n > 0 ? (int)n : 1;
+}
+double omp_get_wtime(void)
+{
+  return xomp_time_stamp();
+}
+double omp_get_wtick(void)
+{
+  return 1.0e-6; // resolution of gettimeofday(), see xomp_time_stamp()
+}
+void omp_init_lock(void *lock)
+{
+  xomp_native_init_lock(lock);
+}
+void omp_destroy_lock(void *lock)
+{
+  xomp_native_destroy_lock(lock);
+}
+void omp_set_lock(void *lock)
+{
+  xomp_native_set_lock(lock);
+}
+void omp_unset_lock(void *lock)
+{
+  xomp_native_unset_lock(lock);
+}
+int omp_test_lock(void *lock)
+{
+  return xomp_native_test_lock(lock);
+}
+void omp_init_nest_lock(void *lock)
+{
+  xomp_native_init_nest_lock(lock);
+}
+void omp_destroy_nest_lock(void *lock)
+{
+  xomp_native_destroy_nest_lock(lock);
+}
+void omp_set_nest_lock(void *lock)
+{
+  xomp_native_set_nest_lock(lock);
+}
+void omp_unset_nest_lock(void *lock)
+{
+  xomp_native_unset_nest_lock(lock);
+}
+int omp_test_nest_lock(void *lock)
+{
+  return xomp_native_test_nest_lock(lock);
+}
+#endif
+
 // Nothing is needed for Fortran case
 #pragma weak xomp_init_=xomp_init
 void xomp_init (void)
@@ -132,7 +238,13 @@ void XOMP_init (int argc, char ** argv)
       fprintf (fp, "%f\t1\n",xomp_time_stamp());
     }
   }
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+
+  // binary per-region profile, see xomp_profile.h
+  xomp_profile_init ();
+
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_init ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 #else   
   _ompc_init (argc, argv);
 #endif    
@@ -152,7 +264,10 @@ void XOMP_terminate (int exitcode)
     fprintf (fp, "%f\t1\n",xomp_time_stamp());
     fclose(fp);
   }
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+  xomp_profile_finish ();
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_terminate ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 #else   
   _ompc_terminate (exitcode);
 #endif    
@@ -248,7 +363,12 @@ void XOMP_parallel_start (void (*func) (void *), void *data, unsigned ifClauseVa
     fprintf (fp,"%f\t1\t%s\t%d\n",xomp_time_stamp(),file_name, line_no);
     fprintf (fp, "%f\t2\t%s\t%d\n",xomp_time_stamp(),file_name, line_no);
   }
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY 
+  // may replace func and data by a wrapper that times each thread
+  xomp_profile_region_start (&func, &data, file_name, line_no);
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_parallel_start (func, data, ifClauseValue ? numThreadsSpecified : 1);
+  func(data);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   // XOMP  to GOMP
   unsigned numThread = 0;
   //numThread is 1 if an IF clause is present and false, 
@@ -283,10 +403,13 @@ void XOMP_parallel_end (char* file_name, int line_no)
     fprintf (fp,"%f\t2\t%s\t%d\n",xomp_time_stamp(),file_name, line_no);
     fprintf (fp, "%f\t1\t%s\t%d\n",xomp_time_stamp(),file_name, line_no);
   }
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_parallel_end ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_parallel_end ();
 #else   
 #endif    
+  xomp_profile_region_end ();
 }
 
 
@@ -303,7 +426,9 @@ int xomp_sections_init_next(int * section_count)
 int XOMP_sections_init_next(int section_count) 
 {
   int result = -1;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  result = xomp_native_sections_start (section_count);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   result = GOMP_sections_start (section_count);
   result --; /*GOMP sections start with 1*/
 #else
@@ -324,7 +449,9 @@ int xomp_sections_next(void)
 int XOMP_sections_next(void)
 {
   int result = -1;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  result = xomp_native_sections_next ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
  result = GOMP_sections_next();
  result --;  /*GOMP sections start with 1*/
 #else
@@ -342,10 +469,14 @@ void xomp_sections_end(void)
 /* Called after the current thread is told that all sections are executed. It synchronizes all threads also. */
 void XOMP_sections_end(void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+  double wait_start = xomp_profile_barrier_begin ();
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_sections_end (false);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_sections_end();
 #else
 #endif
+  xomp_profile_barrier_end (wait_start);
 }
 
 void xomp_sections_end_nowait(void);
@@ -357,7 +488,9 @@ void xomp_sections_end_nowait(void)
 /* Called after the current thread is told that all sections are executed. It does not synchronizes all threads. */
 void XOMP_sections_end_nowait(void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_sections_end (true);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_sections_end_nowait();
 #else
 #endif
@@ -518,7 +651,9 @@ void XOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
                        long arg_size, long arg_align, bool if_clause, unsigned untied)
 {
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_task (fn, data, cpyfn, arg_size, arg_align, if_clause);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 //// only gcc 4.4.x has task support
 // It is fine to have older gcc to compile this, just remember to link with gcc 4.4 and beyond
 //#if __GNUC__ > 4 || \  //
@@ -534,7 +669,9 @@ void XOMP_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
 }
 void XOMP_taskwait (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_taskwait ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
 //#if __GNUC__ > 4 || \           //
 //  (__GNUC__ == 4 && (__GNUC_MINOR__ > 4 || \  //
 //                     (__GNUC_MINOR__ == 4 && \  //
@@ -665,8 +802,8 @@ void xomp_loop_static_init(int* lower, int* upper, int* stride, int* chunk_size)
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_static_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else   
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -688,8 +825,8 @@ void xomp_loop_dynamic_init(int* lower, int* upper, int* stride, int* chunk_size
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_dynamic_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -711,8 +848,8 @@ void xomp_loop_guided_init(int* lower, int* upper, int* stride, int* chunk_size)
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_guided_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -734,8 +871,8 @@ void xomp_loop_runtime_init(int* lower, int* upper, int* stride)
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_runtime_init(int lower, int upper, int stride)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -758,8 +895,8 @@ void xomp_loop_ordered_static_init(int* lower, int* upper, int* stride, int* chu
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_ordered_static_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else   
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -789,8 +926,8 @@ void xomp_loop_ordered_dynamic_init(int* lower, int* upper, int* stride, int* ch
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_ordered_dynamic_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else   
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -817,8 +954,8 @@ void xomp_loop_ordered_guided_init(int* lower, int* upper, int* stride, int* chu
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_ordered_guided_init(int lower, int upper, int stride, int chunk_size)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else   
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -845,8 +982,8 @@ void xomp_loop_ordered_runtime_init(int* lower, int* upper, int* stride)
 // scheduler initialization, only meaningful used for OMNI
 void XOMP_loop_ordered_runtime_init(int lower, int upper, int stride)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
-  // empty operation for gomp
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
+  // empty operation for gomp and the native runtime
 #else   
   // adjust inclusive upper bounds of XOMP to non inclusive bounds of GOMP and OMNI
   if (stride>0)
@@ -892,7 +1029,9 @@ bool XOMP_loop_static_start (long start, long end, long incr, long chunk_size,lo
   else
    end --;
  
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_STATIC, false, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_static_start (start, end, incr, chunk_size, istart, &lend);
 #else   
   rt = _ompc_static_sched_next((int*)istart, (int*)(&lend));
@@ -936,7 +1075,9 @@ bool XOMP_loop_dynamic_start (long start, long end, long incr, long chunk_size,l
   else
    end --;
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_DYNAMIC, false, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_dynamic_start (start, end, incr, chunk_size, istart, &lend);
 #else  
   rt = _ompc_dynamic_sched_next((int*)istart, (int*)(&lend));
@@ -980,7 +1121,9 @@ bool XOMP_loop_guided_start (long start, long end, long incr, long chunk_size,lo
   else
    end --;
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_GUIDED, false, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_guided_start (start, end, incr, chunk_size, istart, &lend);
 #else  
   rt = _ompc_guided_sched_next((int*)istart, (int*)(&lend));
@@ -1024,7 +1167,9 @@ bool XOMP_loop_runtime_start (long start, long end, long incr,long *istart, long
   else
    end --;
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_RUNTIME, false, start, end, incr, 0, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_runtime_start (start, end, incr, istart, &lend);
 #else  
   rt = _ompc_runtime_sched_next((int*)istart, (int*)(&lend));
@@ -1102,7 +1247,9 @@ bool XOMP_loop_ordered_static_start (long start, long end, long incr, long chunk
   else 
    end --;
    
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_STATIC, true, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_static_start (start, end, incr, chunk_size, istart, &lend);
 #else   
   rt = _ompc_static_sched_next((int*)istart, (int*)(&lend));
@@ -1147,7 +1294,9 @@ bool XOMP_loop_ordered_dynamic_start (long start, long end, long incr, long chun
   else 
    end --;
    
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_DYNAMIC, true, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_dynamic_start (start, end, incr, chunk_size, istart, &lend);
 #else   
   rt = _ompc_dynamic_sched_next((int*)istart, (int*)(&lend));
@@ -1192,7 +1341,9 @@ bool XOMP_loop_ordered_guided_start (long start, long end, long incr, long chunk
   else 
    end --;
    
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_GUIDED, true, start, end, incr, chunk_size, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_guided_start (start, end, incr, chunk_size, istart, &lend);
 #else   
   rt = _ompc_guided_sched_next((int*)istart, (int*)(&lend));
@@ -1243,7 +1394,9 @@ bool XOMP_loop_ordered_runtime_start (long start, long end, long incr,long *ista
   else
    end --;
 
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_start (XOMP_NATIVE_RUNTIME, true, start, end, incr, 0, istart, &lend);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_runtime_start (start, end, incr, istart, &lend);
 #else
 #endif
@@ -1320,7 +1473,9 @@ bool XOMP_loop_static_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_static_next (l, &lu);
 #else   
    rt = _ompc_static_sched_next((int*)l, (int*)(&lu));
@@ -1352,7 +1507,9 @@ bool XOMP_loop_dynamic_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_dynamic_next (l, &lu);
 #else
    rt = _ompc_dynamic_sched_next((int*)l, (int*)(&lu));
@@ -1385,7 +1542,9 @@ bool XOMP_loop_guided_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_guided_next (l, &lu);
 #else
    rt = _ompc_guided_sched_next((int*)l, (int*)(&lu));
@@ -1418,7 +1577,9 @@ bool XOMP_loop_runtime_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_runtime_next (l, &lu);
 #else
    rt = _ompc_runtime_sched_next((int*)l, (int*)(&lu));
@@ -1486,7 +1647,9 @@ bool XOMP_loop_ordered_static_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_static_next (l, &lu);
 #else
    rt = _ompc_static_sched_next((int*)l, (int*)(&lu));
@@ -1518,7 +1681,9 @@ bool XOMP_loop_ordered_dynamic_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_dynamic_next (l, &lu);
 #else
    rt = _ompc_dynamic_sched_next((int*)l, (int*)(&lu));
@@ -1551,7 +1716,9 @@ bool XOMP_loop_ordered_guided_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_guided_next (l, &lu);
 #else
    rt = _ompc_guided_sched_next((int*)l, (int*)(&lu));
@@ -1584,7 +1751,9 @@ bool XOMP_loop_ordered_runtime_next (long * l, long *u)
 {
   bool rt;
   long lu;
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  rt = xomp_native_loop_next (l, &lu);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   rt = GOMP_loop_ordered_runtime_next (l, &lu);
 #else
    rt = _ompc_runtime_sched_next((int*)l, (int*)(&lu));
@@ -1670,10 +1839,14 @@ void xomp_loop_end(void)
 }
 void XOMP_loop_end (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+  double wait_start = xomp_profile_barrier_begin ();
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_loop_end (false);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_loop_end();
 #else   
 #endif    
+  xomp_profile_barrier_end (wait_start);
 }
 //---------
 void xomp_loop_end_nowait(void);
@@ -1685,7 +1858,9 @@ void xomp_loop_end_nowait(void)
 
 void XOMP_loop_end_nowait (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_loop_end (true);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_loop_end_nowait();
 #else   
 #endif    
@@ -1700,11 +1875,15 @@ void xomp_barrier(void)
 }
 void XOMP_barrier (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+  double wait_start = xomp_profile_barrier_begin ();
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_barrier ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_barrier();
 #else   
   _ompc_barrier();
 #endif    
+  xomp_profile_barrier_end (wait_start);
 
   //  else
   //  {
@@ -1719,7 +1898,9 @@ void XOMP_barrier (void)
 // be consistent with OMNI
 void XOMP_critical_start (void** data)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+    xomp_native_critical_start (data);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
     GOMP_critical_name_start(data);
 #else   
     _ompc_enter_critical(data);
@@ -1728,7 +1909,9 @@ void XOMP_critical_start (void** data)
 
 void XOMP_critical_end (void** data)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+    xomp_native_critical_end (data);
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
     GOMP_critical_name_end(data);
 #else   
     _ompc_exit_critical(data);
@@ -1743,7 +1926,9 @@ bool xomp_single(void)
 }
 extern bool XOMP_single(void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  return xomp_native_single ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   return GOMP_single_start();
 #else   
   return _ompc_do_single();
@@ -1759,7 +1944,7 @@ bool xomp_master(void)
 
 extern bool XOMP_master(void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   return (omp_get_thread_num() ==0);
 #else   
   return _ompc_is_master ();
@@ -1775,7 +1960,9 @@ void xomp_atomic_start(void)
 }
 void XOMP_atomic_start (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_atomic_start ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_atomic_start();
 #else   
   _ompc_atomic_lock();
@@ -1791,7 +1978,9 @@ void xomp_atomic_end(void)
 }
 void XOMP_atomic_end (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_atomic_end ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
    GOMP_atomic_end();
 #else   
   _ompc_atomic_unlock();
@@ -1800,7 +1989,7 @@ void XOMP_atomic_end (void)
 
 void XOMP_flush_all ()
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   __sync_synchronize();
 #else   
   _ompc_flush(0,0);
@@ -1809,7 +1998,7 @@ void XOMP_flush_all ()
 
 void XOMP_flush_one(char * startAddress, int nbyte)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME) || defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   __sync_synchronize();
 #else   
   _ompc_flush(startAddress,nbyte);
@@ -1818,7 +2007,9 @@ void XOMP_flush_one(char * startAddress, int nbyte)
 
 void XOMP_ordered_start (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_ordered_start ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
    GOMP_ordered_start();
 #else   
 #endif
@@ -1826,7 +2017,9 @@ void XOMP_ordered_start (void)
 }
 void XOMP_ordered_end (void)
 {
-#ifdef USE_ROSE_GOMP_OPENMP_LIBRARY  
+#if defined(USE_ROSE_NATIVE_XOMP_RUNTIME)
+  xomp_native_ordered_end ();
+#elif defined(USE_ROSE_GOMP_OPENMP_LIBRARY)
   GOMP_ordered_end();
 #else   
 
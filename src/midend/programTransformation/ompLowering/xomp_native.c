@@ -0,0 +1,1172 @@
+// Native XOMP runtime: a pthread pool with work-stealing task deques, self-scheduled loops and NUMA-aware pinning.
+// See xomp_native.h for an overview and the environment variables it reads.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for CPU_SET() and pthread_setaffinity_np()
+#endif
+
+#include "xomp_native.h"
+
+#include <assert.h>
+#include <dirent.h>
+#include <pthread.h>
+#include <sched.h>
+#include <stddef.h> // for offsetof()
+#include <stdint.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <strings.h> // for strncasecmp()
+#include <unistd.h>
+
+#define XOMP_MAX_THREADS 256
+#define XOMP_DEQUE_SIZE 8192   // tasks per deque, must be a power of two. A full deque runs new tasks immediately
+#define XOMP_WS_SLOTS 8        // worksharing constructs that can be in progress at once (nowait lets threads run ahead)
+#define XOMP_SPIN_LIMIT 20000  // busy-wait iterations before yielding the CPU or sleeping
+#define XOMP_SPIN_LIMIT_OVERSUBSCRIBED 100 // ... when there are more threads than CPUs
+#define XOMP_CACHE_LINE 64
+
+#if defined(__i386__) || defined(__x86_64__)
+#define xomp_cpu_relax() __builtin_ia32_pause()
+#else
+#define xomp_cpu_relax() __atomic_thread_fence(__ATOMIC_SEQ_CST)
+#endif
+
+//---------------------------------------------
+// Data structures
+
+struct xomp_task
+{
+  void (*fn) (void *);
+  void *data;                   // private copy of the task's arguments, stored right after this struct
+  struct xomp_task *parent;
+  long refs;                    // 1 until the task has run, plus 1 for each child not yet released
+  bool deferred;                // queued in a deque and counted in its team's ntasks
+};
+
+// Chase-Lev deque: the owner pushes and pops at the bottom, thieves take from the top
+struct xomp_deque
+{
+  long top __attribute__((aligned(XOMP_CACHE_LINE)));
+  long bottom __attribute__((aligned(XOMP_CACHE_LINE)));
+  struct xomp_task *slots[XOMP_DEQUE_SIZE];
+};
+
+// State shared by the team for one worksharing construct (loop, sections, or single)
+struct xomp_ws
+{
+  unsigned long ticket;         // number of the construct allowed to use this slot next
+  int state;                    // 0: free, 1: being initialized, 2: ready
+  int nleft;                    // members done with the construct
+  enum xomp_native_sched sched;
+  long start;                   // the iterations are start, start+incr, ... (n of them)
+  long incr;
+  long n;
+  long chunk;
+  int lock;                     // ordered loops hand out chunks under this lock
+  long nchunks;                 // ordered: chunks handed out so far
+  long ordered_seq;             // ordered: sequence number of the chunk whose ordered region may run
+  long next __attribute__((aligned(XOMP_CACHE_LINE))); // next unassigned iteration, section, or single claim
+} __attribute__((aligned(XOMP_CACHE_LINE)));
+
+struct xomp_team
+{
+  int nthreads;
+  long ntasks;                  // deferred tasks not yet completed
+  int barrier_count __attribute__((aligned(XOMP_CACHE_LINE)));
+  unsigned long barrier_gen;    // never reset, since late threads may still be watching it
+  struct xomp_ws ws[XOMP_WS_SLOTS];
+};
+
+struct xomp_worker;
+
+// A thread's place in a team
+struct xomp_member
+{
+  struct xomp_team *team;
+  int id;
+  struct xomp_worker *worker;   // NULL in a serialized team, which never defers tasks
+  struct xomp_member *prev;     // context to restore when a serialized region ends
+  struct xomp_task implicit;
+  struct xomp_task *task;       // task being executed
+  unsigned long ws_count;       // worksharing constructs encountered so far in this region
+  struct xomp_ws *ws;           // current worksharing construct
+  bool ordered;                 // current loop is ordered
+  long seq;                     // ordered: sequence number of the chunk being executed, or -1
+  long static_next;             // static: next chunk number owned by this thread, or -1
+};
+
+// A pool thread. Each allocates its own worker so that the deque is first touched on the thread's NUMA node.
+struct xomp_worker
+{
+  struct xomp_deque deque;
+  struct xomp_member member;    // place in the pool team
+  pthread_t handle;
+  unsigned seed;                // victim selection
+};
+
+// Team of one thread for a nested region, or for worksharing outside of any region
+struct xomp_serial
+{
+  struct xomp_team team;
+  struct xomp_member member;
+};
+
+//---------------------------------------------
+// Global state
+
+static pthread_once_t xomp_once = PTHREAD_ONCE_INIT;
+static int xomp_max_threads = 1;
+static int xomp_online_cpus = 1;
+static unsigned xomp_spin_limit = XOMP_SPIN_LIMIT; // read by idle workers while a new region sets it, so accessed atomically
+static enum { XOMP_BIND_NONE, XOMP_BIND_CLOSE, XOMP_BIND_SPREAD } xomp_bind = XOMP_BIND_NONE;
+static int *xomp_cpus = NULL;   // CPU for each thread number (modulo xomp_ncpus) when binding
+static int xomp_ncpus = 0;
+static enum xomp_native_sched xomp_runtime_sched = XOMP_NATIVE_DYNAMIC;
+static long xomp_runtime_chunk = 1;
+
+static struct xomp_worker *xomp_workers[XOMP_MAX_THREADS];
+static int xomp_nworkers = 0;   // pool size, including the slot of the thread that starts regions
+static struct xomp_team xomp_pool_team;
+static int xomp_pool_busy = 0;  // an outermost region is running on the pool
+static int xomp_shutdown = 0;
+static unsigned long xomp_region_gen = 0;
+static int xomp_pool_active = 0; // pool workers that have not yet left the current region
+static void (*xomp_region_fn) (void *) = NULL;
+static void *xomp_region_data = NULL;
+static pthread_mutex_t xomp_pool_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_cond_t xomp_pool_cond = PTHREAD_COND_INITIALIZER;
+
+static pthread_mutex_t xomp_atomic_lock = PTHREAD_MUTEX_INITIALIZER;
+static pthread_mutex_t xomp_critical_lock = PTHREAD_MUTEX_INITIALIZER; // unnamed critical sections
+
+static __thread struct xomp_member *xomp_current = NULL; // NULL outside of parallel regions
+static __thread struct xomp_member *xomp_orphan = NULL;  // for worksharing outside of parallel regions
+
+static void xomp_backoff (unsigned *spins)
+{
+  if (++(*spins) < __atomic_load_n(&xomp_spin_limit, __ATOMIC_RELAXED))
+    xomp_cpu_relax();
+  else
+    sched_yield();
+}
+
+static void* xomp_aligned_alloc (size_t size)
+{
+  void *p = NULL;
+  if (posix_memalign(&p, XOMP_CACHE_LINE, size) != 0)
+  {
+    fprintf(stderr, "xomp_native.c: out of memory allocating %lu bytes\n", (unsigned long)size);
+    abort();
+  }
+  memset(p, 0, size);
+  return p;
+}
+
+//---------------------------------------------
+// Environment and thread placement
+
+// Parse a Linux cpulist such as "0-3,8,10-11"
+static void parse_cpulist (const char *s, cpu_set_t *set)
+{
+  CPU_ZERO(set);
+  while (*s)
+  {
+    char *rest;
+    long lo = strtol(s, &rest, 10), hi = lo;
+    if (rest == s)
+      break;
+    if (*rest == '-')
+      hi = strtol(rest+1, &rest, 10);
+    for (; lo <= hi && lo < CPU_SETSIZE; lo++)
+      CPU_SET(lo, set);
+    s = (*rest == ',') ? rest+1 : rest;
+    if (*s == '\n')
+      break;
+  }
+}
+
+// Decide which CPU each thread number is pinned to. CPUs of a NUMA node are listed together for "close" and
+// interleaved across nodes for "spread". Without /sys/devices/system/node all CPUs are treated as one node.
+static void plan_placement (void)
+{
+  cpu_set_t allowed;
+  int node_of[CPU_SETSIZE];
+  int nnodes = 1, cpu, node;
+
+  if (sched_getaffinity(0, sizeof allowed, &allowed) != 0 || CPU_COUNT(&allowed) == 0)
+  {
+    xomp_bind = XOMP_BIND_NONE;
+    return;
+  }
+  for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+    node_of[cpu] = 0;
+
+  DIR *dir = opendir("/sys/devices/system/node");
+  if (dir != NULL)
+  {
+    struct dirent *entry;
+    while ((entry = readdir(dir)) != NULL)
+    {
+      if (strncmp(entry->d_name, "node", 4) != 0 || sscanf(entry->d_name + 4, "%d", &node) != 1)
+        continue;
+      char path[300], line[4096];
+      snprintf(path, sizeof path, "/sys/devices/system/node/%s/cpulist", entry->d_name);
+      FILE *f = fopen(path, "r");
+      if (f == NULL)
+        continue;
+      if (fgets(line, sizeof line, f) != NULL)
+      {
+        cpu_set_t cpus;
+        parse_cpulist(line, &cpus);
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+          if (CPU_ISSET(cpu, &cpus))
+            node_of[cpu] = node;
+        }
+        if (node + 1 > nnodes)
+          nnodes = node + 1;
+      }
+      fclose(f);
+    }
+    closedir(dir);
+  }
+
+  xomp_cpus = (int*) malloc(sizeof(int) * CPU_COUNT(&allowed));
+  assert(xomp_cpus != NULL);
+  xomp_ncpus = 0;
+  if (xomp_bind == XOMP_BIND_CLOSE)
+  {
+    for (node = 0; node < nnodes; node++)
+      for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        if (CPU_ISSET(cpu, &allowed) && node_of[cpu] == node)
+          xomp_cpus[xomp_ncpus++] = cpu;
+  }
+  else
+  {
+    // round r takes the r-th allowed CPU of every node that has one
+    int round, added = 1;
+    for (round = 0; added; round++)
+    {
+      added = 0;
+      for (node = 0; node < nnodes; node++)
+      {
+        int nth = 0;
+        for (cpu = 0; cpu < CPU_SETSIZE; cpu++)
+        {
+          if (CPU_ISSET(cpu, &allowed) && node_of[cpu] == node && nth++ == round)
+          {
+            xomp_cpus[xomp_ncpus++] = cpu;
+            added = 1;
+            break;
+          }
+        }
+      }
+    }
+  }
+}
+
+static const char* getenv2 (const char *name1, const char *name2)
+{
+  const char *value = getenv(name1);
+  return value != NULL ? value : getenv(name2);
+}
+
+static void initialize (void)
+{
+  const char *value;
+
+  long ncpus = sysconf(_SC_NPROCESSORS_ONLN);
+  xomp_online_cpus = ncpus > 0 ? (int)ncpus : 1;
+  xomp_max_threads = xomp_online_cpus;
+  if ((value = getenv2("XOMP_NUM_THREADS", "OMP_NUM_THREADS")) != NULL && atoi(value) > 0)
+    xomp_max_threads = atoi(value);
+  if (xomp_max_threads > XOMP_MAX_THREADS)
+    xomp_max_threads = XOMP_MAX_THREADS;
+
+  if ((value = getenv2("XOMP_PROC_BIND", "OMP_PROC_BIND")) != NULL)
+  {
+    if (strncasecmp(value, "true", 4) == 0 || strncasecmp(value, "close", 5) == 0)
+      xomp_bind = XOMP_BIND_CLOSE;
+    else if (strncasecmp(value, "spread", 6) == 0)
+      xomp_bind = XOMP_BIND_SPREAD;
+  }
+  if (xomp_bind != XOMP_BIND_NONE)
+    plan_placement();
+
+  if ((value = getenv("OMP_SCHEDULE")) != NULL)
+  {
+    if (strncasecmp(value, "static", 6) == 0 || strncasecmp(value, "auto", 4) == 0)
+      xomp_runtime_sched = XOMP_NATIVE_STATIC;
+    else if (strncasecmp(value, "guided", 6) == 0)
+      xomp_runtime_sched = XOMP_NATIVE_GUIDED;
+    xomp_runtime_chunk = xomp_runtime_sched == XOMP_NATIVE_STATIC ? 0 : 1;
+    const char *comma = strchr(value, ',');
+    if (comma != NULL && atol(comma+1) > 0)
+      xomp_runtime_chunk = atol(comma+1);
+  }
+}
+
+static void pin_thread (int thread_num)
+{
+  if (xomp_bind == XOMP_BIND_NONE || xomp_ncpus == 0)
+    return;
+  cpu_set_t set;
+  CPU_ZERO(&set);
+  CPU_SET(xomp_cpus[thread_num % xomp_ncpus], &set);
+  pthread_setaffinity_np(pthread_self(), sizeof set, &set);
+}
+
+//---------------------------------------------
+// Work-stealing deque
+
+static bool deque_push (struct xomp_deque *q, struct xomp_task *task)
+{
+  long b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED);
+  long t = __atomic_load_n(&q->top, __ATOMIC_ACQUIRE);
+  if (b - t >= XOMP_DEQUE_SIZE)
+    return false;
+  __atomic_store_n(&q->slots[b & (XOMP_DEQUE_SIZE-1)], task, __ATOMIC_RELAXED);
+  __atomic_store_n(&q->bottom, b+1, __ATOMIC_RELEASE);
+  return true;
+}
+
+static struct xomp_task* deque_pop (struct xomp_deque *q)
+{
+  long b = __atomic_load_n(&q->bottom, __ATOMIC_RELAXED) - 1;
+  __atomic_store_n(&q->bottom, b, __ATOMIC_RELAXED);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  long t = __atomic_load_n(&q->top, __ATOMIC_RELAXED);
+  struct xomp_task *task = NULL;
+  if (t <= b)
+  {
+    task = __atomic_load_n(&q->slots[b & (XOMP_DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+    if (t == b)
+    {
+      // last task: a thief may be taking it too
+      if (!__atomic_compare_exchange_n(&q->top, &t, t+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+        task = NULL;
+      __atomic_store_n(&q->bottom, b+1, __ATOMIC_RELAXED);
+    }
+  }
+  else
+    __atomic_store_n(&q->bottom, b+1, __ATOMIC_RELAXED);
+  return task;
+}
+
+static struct xomp_task* deque_steal (struct xomp_deque *q)
+{
+  long t = __atomic_load_n(&q->top, __ATOMIC_ACQUIRE);
+  __atomic_thread_fence(__ATOMIC_SEQ_CST);
+  long b = __atomic_load_n(&q->bottom, __ATOMIC_ACQUIRE);
+  if (t < b)
+  {
+    struct xomp_task *task = __atomic_load_n(&q->slots[t & (XOMP_DEQUE_SIZE-1)], __ATOMIC_RELAXED);
+    if (__atomic_compare_exchange_n(&q->top, &t, t+1, false, __ATOMIC_SEQ_CST, __ATOMIC_RELAXED))
+      return task;
+  }
+  return NULL;
+}
+
+//---------------------------------------------
+// Teams
+
+static void team_reset (struct xomp_team *team, int nthreads)
+{
+  int i;
+  team->nthreads = nthreads;
+  team->ntasks = 0;
+  team->barrier_count = 0;
+  for (i = 0; i < XOMP_WS_SLOTS; i++)
+  {
+    team->ws[i].ticket = i;
+    team->ws[i].state = 0;
+    team->ws[i].nleft = 0;
+  }
+}
+
+static void member_reset (struct xomp_member *m, struct xomp_team *team, int id, struct xomp_worker *worker)
+{
+  m->team = team;
+  m->id = id;
+  m->worker = worker;
+  m->prev = NULL;
+  memset(&m->implicit, 0, sizeof m->implicit);
+  m->implicit.refs = 1;
+  m->task = &m->implicit;
+  m->ws_count = 0;
+  m->ws = NULL;
+  m->ordered = false;
+  m->seq = -1;
+  m->static_next = -1;
+}
+
+static struct xomp_member* serial_begin (struct xomp_member *prev)
+{
+  struct xomp_serial *s = (struct xomp_serial*) xomp_aligned_alloc(sizeof(struct xomp_serial));
+  team_reset(&s->team, 1);
+  member_reset(&s->member, &s->team, 0, NULL);
+  s->member.prev = prev;
+  return &s->member;
+}
+
+static void serial_end (struct xomp_member *m)
+{
+  free((char*)m - offsetof(struct xomp_serial, member));
+}
+
+static struct xomp_member* current_member (void)
+{
+  if (xomp_current != NULL)
+    return xomp_current;
+  if (xomp_orphan == NULL)
+    xomp_orphan = serial_begin(NULL);
+  return xomp_orphan;
+}
+
+//---------------------------------------------
+// Tasks
+
+// Drop a reference to a task. The last reference frees it and releases its parent's reference.
+static void task_release (struct xomp_task *task)
+{
+  while (task != NULL && __atomic_sub_fetch(&task->refs, 1, __ATOMIC_ACQ_REL) == 0)
+  {
+    struct xomp_task *parent = task->parent;
+    free(task);
+    task = parent;
+  }
+}
+
+static void task_run (struct xomp_member *m, struct xomp_task *task)
+{
+  bool deferred = task->deferred;
+  struct xomp_task *saved = m->task;
+  m->task = task;
+  task->fn(task->data);
+  m->task = saved;
+  task_release(task);
+  if (deferred)
+    __atomic_sub_fetch(&m->team->ntasks, 1, __ATOMIC_ACQ_REL);
+}
+
+// Run one task from this thread's deque, or else one stolen from a random victim
+static bool run_one_task (struct xomp_member *m)
+{
+  struct xomp_worker *w = m->worker;
+  if (w == NULL)
+    return false;
+  struct xomp_task *task = deque_pop(&w->deque);
+  int n = m->team->nthreads;
+  if (task == NULL && n > 1)
+  {
+    int i;
+    w->seed = w->seed * 1103515245u + 12345u;
+    int first = (int)((w->seed >> 16) % (unsigned)n);
+    for (i = 0; i < n && task == NULL; i++)
+    {
+      int victim = (first + i) % n;
+      if (victim != m->id)
+        task = deque_steal(&xomp_workers[victim]->deque);
+    }
+  }
+  if (task == NULL)
+    return false;
+  task_run(m, task);
+  return true;
+}
+
+void xomp_native_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
+                       long arg_size, long arg_align, bool if_clause)
+{
+  struct xomp_member *m = current_member();
+  if (arg_size < 0)
+    arg_size = 0;
+  if (arg_align < 1)
+    arg_align = 1;
+
+  struct xomp_task *task = (struct xomp_task*) malloc(sizeof(struct xomp_task) + arg_size + arg_align - 1);
+  assert(task != NULL);
+  uintptr_t arg = ((uintptr_t)(task + 1) + arg_align - 1) & ~(uintptr_t)(arg_align - 1);
+  if (cpyfn != NULL)
+    cpyfn((void*)arg, data);
+  else if (arg_size > 0)
+    memcpy((void*)arg, data, arg_size);
+  task->fn = fn;
+  task->data = (void*)arg;
+  task->parent = m->task;
+  task->refs = 1;
+  __atomic_add_fetch(&m->task->refs, 1, __ATOMIC_RELAXED);
+
+  task->deferred = if_clause && m->worker != NULL && m->team->nthreads > 1;
+  if (task->deferred)
+  {
+    __atomic_add_fetch(&m->team->ntasks, 1, __ATOMIC_ACQ_REL);
+    if (deque_push(&m->worker->deque, task))
+      return;
+    __atomic_sub_fetch(&m->team->ntasks, 1, __ATOMIC_ACQ_REL);
+    task->deferred = false;
+  }
+  task_run(m, task);
+}
+
+void xomp_native_taskwait (void)
+{
+  struct xomp_member *m = current_member();
+  struct xomp_task *task = m->task;
+  unsigned spins = 0;
+  while (__atomic_load_n(&task->refs, __ATOMIC_ACQUIRE) > 1)
+  {
+    if (run_one_task(m))
+      spins = 0;
+    else
+      xomp_backoff(&spins);
+  }
+}
+
+//---------------------------------------------
+// Barrier. Waiting threads execute tasks; the last to arrive also waits until every task of the team completed.
+
+static void team_barrier (struct xomp_member *m)
+{
+  struct xomp_team *team = m->team;
+  unsigned spins = 0;
+  if (team->nthreads == 1)
+    return;                     // a team of one never defers tasks
+  unsigned long gen = __atomic_load_n(&team->barrier_gen, __ATOMIC_ACQUIRE);
+  if (__atomic_add_fetch(&team->barrier_count, 1, __ATOMIC_ACQ_REL) == team->nthreads)
+  {
+    while (__atomic_load_n(&team->ntasks, __ATOMIC_ACQUIRE) > 0)
+    {
+      if (run_one_task(m))
+        spins = 0;
+      else
+        xomp_backoff(&spins);
+    }
+    team->barrier_count = 0;
+    __atomic_store_n(&team->barrier_gen, gen + 1, __ATOMIC_RELEASE);
+  }
+  else
+  {
+    while (__atomic_load_n(&team->barrier_gen, __ATOMIC_ACQUIRE) == gen)
+    {
+      if (run_one_task(m))
+        spins = 0;
+      else
+        xomp_backoff(&spins);
+    }
+  }
+}
+
+void xomp_native_barrier (void)
+{
+  team_barrier(current_member());
+}
+
+//---------------------------------------------
+// Thread pool and parallel regions
+
+static struct xomp_worker* worker_new (int thread_num)
+{
+  pin_thread(thread_num);
+  struct xomp_worker *w = (struct xomp_worker*) xomp_aligned_alloc(sizeof(struct xomp_worker));
+  w->handle = pthread_self();
+  w->seed = 2654435761u * (unsigned)(thread_num + 1);
+  return w;
+}
+
+static void* worker_main (void *arg)
+{
+  int thread_num = (int)(intptr_t)arg;
+  struct xomp_worker *w = worker_new(thread_num);
+  unsigned long seen = __atomic_load_n(&xomp_region_gen, __ATOMIC_ACQUIRE);
+  __atomic_store_n(&xomp_workers[thread_num], w, __ATOMIC_RELEASE);
+
+  while (true)
+  {
+    unsigned long gen;
+    unsigned spins = 0;
+    while ((gen = __atomic_load_n(&xomp_region_gen, __ATOMIC_ACQUIRE)) == seen)
+    {
+      if (++spins < __atomic_load_n(&xomp_spin_limit, __ATOMIC_RELAXED))
+        xomp_cpu_relax();
+      else
+      {
+        pthread_mutex_lock(&xomp_pool_lock);
+        while (__atomic_load_n(&xomp_region_gen, __ATOMIC_ACQUIRE) == seen)
+          pthread_cond_wait(&xomp_pool_cond, &xomp_pool_lock);
+        pthread_mutex_unlock(&xomp_pool_lock);
+      }
+    }
+    seen = gen;
+    if (__atomic_load_n(&xomp_shutdown, __ATOMIC_ACQUIRE))
+      break;
+    if (thread_num >= xomp_pool_team.nthreads)
+      continue;
+    xomp_current = &w->member;
+    xomp_region_fn(xomp_region_data);
+    team_barrier(&w->member);
+    xomp_current = NULL;
+    // From here on this thread doesn't touch the team or its member, so the next region may reset them
+    __atomic_sub_fetch(&xomp_pool_active, 1, __ATOMIC_RELEASE);
+  }
+  return NULL;
+}
+
+// Called only by the thread that owns the pool
+static void pool_grow (int nthreads)
+{
+  if (xomp_nworkers == 0)
+  {
+    xomp_workers[0] = worker_new(0);
+    xomp_nworkers = 1;
+  }
+  while (xomp_nworkers < nthreads)
+  {
+    pthread_t handle;
+    int thread_num = xomp_nworkers;
+    if (pthread_create(&handle, NULL, worker_main, (void*)(intptr_t)thread_num) != 0)
+      break;                    // run with the threads we have
+    while (__atomic_load_n(&xomp_workers[thread_num], __ATOMIC_ACQUIRE) == NULL)
+      sched_yield();
+    xomp_nworkers++;
+  }
+}
+
+static void pool_wake (void)
+{
+  pthread_mutex_lock(&xomp_pool_lock);
+  __atomic_add_fetch(&xomp_region_gen, 1, __ATOMIC_RELEASE);
+  pthread_cond_broadcast(&xomp_pool_cond);
+  pthread_mutex_unlock(&xomp_pool_lock);
+}
+
+void xomp_native_init (void)
+{
+  pthread_once(&xomp_once, initialize);
+  int expected = 0;
+  if (xomp_current == NULL && __atomic_compare_exchange_n(&xomp_pool_busy, &expected, 1, false,
+                                                           __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  {
+    pool_grow(xomp_max_threads);
+    __atomic_store_n(&xomp_pool_busy, 0, __ATOMIC_RELEASE);
+  }
+}
+
+void xomp_native_terminate (void)
+{
+  int i, expected = 0;
+  if (!__atomic_compare_exchange_n(&xomp_pool_busy, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return;                     // a region is still running
+  if (xomp_nworkers > 0)
+  {
+    __atomic_store_n(&xomp_shutdown, 1, __ATOMIC_RELEASE);
+    pool_wake();
+    for (i = 1; i < xomp_nworkers; i++)
+      pthread_join(xomp_workers[i]->handle, NULL);
+    for (i = 0; i < xomp_nworkers; i++)
+    {
+      free(xomp_workers[i]);
+      xomp_workers[i] = NULL;
+    }
+    xomp_nworkers = 0;
+    xomp_shutdown = 0;
+  }
+  __atomic_store_n(&xomp_pool_busy, 0, __ATOMIC_RELEASE);
+}
+
+void xomp_native_parallel_start (void (*func) (void *), void *data, unsigned numThreads)
+{
+  int i, expected = 0;
+  pthread_once(&xomp_once, initialize);
+  int n = numThreads == 0 ? xomp_max_threads : (int)numThreads;
+  if (n > XOMP_MAX_THREADS)
+    n = XOMP_MAX_THREADS;
+
+  // Nested regions, and regions started while another thread owns the pool, are serialized
+  if (xomp_current != NULL || n == 1 ||
+      !__atomic_compare_exchange_n(&xomp_pool_busy, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+  {
+    xomp_current = serial_begin(xomp_current);
+    return;
+  }
+
+  pool_grow(n);
+  if (n > xomp_nworkers)
+    n = xomp_nworkers;
+  __atomic_store_n(&xomp_spin_limit, n > xomp_online_cpus ? XOMP_SPIN_LIMIT_OVERSUBSCRIBED : XOMP_SPIN_LIMIT,
+                   __ATOMIC_RELAXED);
+  team_reset(&xomp_pool_team, n);
+  for (i = 0; i < n; i++)
+    member_reset(&xomp_workers[i]->member, &xomp_pool_team, i, xomp_workers[i]);
+  xomp_region_fn = func;
+  xomp_region_data = data;
+  __atomic_store_n(&xomp_pool_active, n - 1, __ATOMIC_RELAXED); // published by pool_wake()
+  pool_wake();
+  xomp_current = &xomp_workers[0]->member;
+}
+
+void xomp_native_parallel_end (void)
+{
+  struct xomp_member *m = xomp_current;
+  assert(m != NULL);
+  team_barrier(m);
+  if (m->worker == NULL)
+  {
+    xomp_current = m->prev;
+    serial_end(m);
+    return;
+  }
+  xomp_current = NULL;
+
+  // Threads released by the final barrier may still be running tasks or checking the barrier generation. Wait until
+  // they have left the region, so the next region can reset the team and the members without racing with them.
+  unsigned spins = 0;
+  while (__atomic_load_n(&xomp_pool_active, __ATOMIC_ACQUIRE) > 0)
+    xomp_backoff(&spins);
+  __atomic_store_n(&xomp_pool_busy, 0, __ATOMIC_RELEASE);
+}
+
+int xomp_native_thread_num (void)
+{
+  return xomp_current != NULL ? xomp_current->id : 0;
+}
+
+int xomp_native_num_threads (void)
+{
+  return xomp_current != NULL ? xomp_current->team->nthreads : 1;
+}
+
+int xomp_native_max_threads (void)
+{
+  pthread_once(&xomp_once, initialize);
+  return xomp_max_threads;
+}
+
+void xomp_native_set_num_threads (int n)
+{
+  pthread_once(&xomp_once, initialize);
+  if (n > 0)
+    xomp_max_threads = n < XOMP_MAX_THREADS ? n : XOMP_MAX_THREADS;
+}
+
+bool xomp_native_in_parallel (void)
+{
+  return xomp_current != NULL && xomp_current->team->nthreads > 1;
+}
+
+//---------------------------------------------
+// Worksharing constructs share a ring of slots. The member that enters construct k first initializes slot
+// k % XOMP_WS_SLOTS once the previous user, construct k - XOMP_WS_SLOTS, has been left by every member.
+
+static struct xomp_ws* ws_enter (struct xomp_member *m, bool *first)
+{
+  unsigned long k = m->ws_count++;
+  struct xomp_ws *ws = &m->team->ws[k % XOMP_WS_SLOTS];
+  unsigned spins = 0;
+  int expected = 0;
+  while (__atomic_load_n(&ws->ticket, __ATOMIC_ACQUIRE) != k)
+    xomp_backoff(&spins);
+  m->ws = ws;
+  *first = __atomic_compare_exchange_n(&ws->state, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+  if (!*first)
+  {
+    while (__atomic_load_n(&ws->state, __ATOMIC_ACQUIRE) != 2)
+      xomp_backoff(&spins);
+  }
+  return ws;
+}
+
+static void ws_publish (struct xomp_ws *ws)
+{
+  __atomic_store_n(&ws->state, 2, __ATOMIC_RELEASE);
+}
+
+static void ws_leave (struct xomp_member *m)
+{
+  struct xomp_ws *ws = m->ws;
+  if (ws == NULL)
+    return;
+  m->ws = NULL;
+  if (__atomic_add_fetch(&ws->nleft, 1, __ATOMIC_ACQ_REL) == m->team->nthreads)
+  {
+    ws->nleft = 0;
+    ws->state = 0;
+    __atomic_store_n(&ws->ticket, ws->ticket + XOMP_WS_SLOTS, __ATOMIC_RELEASE);
+  }
+}
+
+//---------------------------------------------
+// Loops. Chunks are computed in iteration numbers 0..n-1 and converted to loop bounds at the end.
+
+static long iteration_count (long start, long end, long incr)
+{
+  if (incr > 0)
+    return start < end ? (end - start + incr - 1) / incr : 0;
+  return start > end ? (start - end - incr - 1) / -incr : 0;
+}
+
+// Wait for this member's turn in the ordered sequence, if it holds a chunk of an ordered loop
+static void ordered_wait (struct xomp_member *m)
+{
+  unsigned spins = 0;
+  if (!m->ordered || m->ws == NULL || m->seq < 0)
+    return;
+  while (__atomic_load_n(&m->ws->ordered_seq, __ATOMIC_ACQUIRE) != m->seq)
+    xomp_backoff(&spins);
+}
+
+// The chunk held is done: let the next chunk in sequence into its ordered region
+static void ordered_release (struct xomp_member *m)
+{
+  if (!m->ordered || m->ws == NULL || m->seq < 0)
+    return;
+  ordered_wait(m);
+  __atomic_store_n(&m->ws->ordered_seq, m->seq + 1, __ATOMIC_RELEASE);
+  m->seq = -1;
+}
+
+static bool static_chunk (struct xomp_member *m, struct xomp_ws *ws, long *from, long *to)
+{
+  long nthreads = m->team->nthreads;
+  if (m->static_next < 0)
+    return false;
+  if (ws->chunk <= 0)
+  {
+    // one block per thread; the first n % nthreads threads take one extra iteration
+    long size = ws->n / nthreads, extra = ws->n % nthreads, id = m->id;
+    *from = id * size + (id < extra ? id : extra);
+    *to = *from + size + (id < extra ? 1 : 0);
+    m->static_next = -1;
+    m->seq = id;
+  }
+  else
+  {
+    *from = m->static_next * ws->chunk;
+    if (*from >= ws->n)
+    {
+      m->static_next = -1;
+      return false;
+    }
+    *to = *from + ws->chunk < ws->n ? *from + ws->chunk : ws->n;
+    m->seq = m->static_next;
+    m->static_next += nthreads;
+  }
+  if (*from >= *to)
+  {
+    m->seq = -1;
+    return false;
+  }
+  return true;
+}
+
+// Size of the next chunk when "remaining" iterations are left
+static long chunk_size (struct xomp_ws *ws, long remaining, int nthreads)
+{
+  long q = ws->chunk;
+  if (ws->sched == XOMP_NATIVE_GUIDED)
+  {
+    q = (remaining + nthreads - 1) / nthreads;
+    if (q < ws->chunk)
+      q = ws->chunk;
+  }
+  return q < remaining ? q : remaining;
+}
+
+static bool shared_chunk (struct xomp_member *m, struct xomp_ws *ws, long *from, long *to)
+{
+  if (m->ordered)
+  {
+    // chunks are numbered in iteration order, which the ordered regions follow
+    bool found = false;
+    while (__atomic_exchange_n(&ws->lock, 1, __ATOMIC_ACQUIRE))
+      xomp_cpu_relax();
+    if (ws->next < ws->n)
+    {
+      *from = ws->next;
+      *to = *from + chunk_size(ws, ws->n - *from, m->team->nthreads);
+      ws->next = *to;
+      m->seq = ws->nchunks++;
+      found = true;
+    }
+    __atomic_store_n(&ws->lock, 0, __ATOMIC_RELEASE);
+    return found;
+  }
+
+  if (ws->sched == XOMP_NATIVE_DYNAMIC)
+  {
+    *from = __atomic_fetch_add(&ws->next, ws->chunk, __ATOMIC_RELAXED);
+    if (*from >= ws->n)
+      return false;
+    *to = *from + ws->chunk < ws->n ? *from + ws->chunk : ws->n;
+    return true;
+  }
+
+  *from = __atomic_load_n(&ws->next, __ATOMIC_RELAXED);
+  do
+  {
+    if (*from >= ws->n)
+      return false;
+    *to = *from + chunk_size(ws, ws->n - *from, m->team->nthreads);
+  }
+  while (!__atomic_compare_exchange_n(&ws->next, from, *to, true, __ATOMIC_RELAXED, __ATOMIC_RELAXED));
+  return true;
+}
+
+static bool loop_next (struct xomp_member *m, long *istart, long *iend)
+{
+  struct xomp_ws *ws = m->ws;
+  long from, to;
+  bool found;
+  if (ws == NULL)
+    return false;
+  ordered_release(m);
+  if (ws->sched == XOMP_NATIVE_STATIC)
+    found = static_chunk(m, ws, &from, &to);
+  else
+    found = shared_chunk(m, ws, &from, &to);
+  if (!found)
+    return false;
+  *istart = ws->start + from * ws->incr;
+  *iend = ws->start + to * ws->incr;
+  return true;
+}
+
+bool xomp_native_loop_start (enum xomp_native_sched sched, bool ordered, long start, long end, long incr,
+                             long chunk_size, long *istart, long *iend)
+{
+  struct xomp_member *m = current_member();
+  bool first;
+  if (sched == XOMP_NATIVE_RUNTIME)
+  {
+    sched = xomp_runtime_sched;
+    chunk_size = xomp_runtime_chunk;
+  }
+  if (sched != XOMP_NATIVE_STATIC && chunk_size < 1)
+    chunk_size = 1;
+
+  struct xomp_ws *ws = ws_enter(m, &first);
+  if (first)
+  {
+    ws->sched = sched;
+    ws->start = start;
+    ws->incr = incr;
+    ws->n = iteration_count(start, end, incr);
+    ws->chunk = chunk_size;
+    ws->next = 0;
+    ws->nchunks = 0;
+    ws->ordered_seq = 0;
+    ws->lock = 0;
+    ws_publish(ws);
+  }
+  m->ordered = ordered;
+  m->seq = -1;
+  m->static_next = m->id;
+  return loop_next(m, istart, iend);
+}
+
+bool xomp_native_loop_next (long *istart, long *iend)
+{
+  return loop_next(current_member(), istart, iend);
+}
+
+void xomp_native_loop_end (bool nowait)
+{
+  struct xomp_member *m = current_member();
+  ordered_release(m);
+  m->ordered = false;
+  ws_leave(m);
+  if (!nowait)
+    team_barrier(m);
+}
+
+void xomp_native_ordered_start (void)
+{
+  ordered_wait(current_member());
+}
+
+// The turn passes to the next chunk when this chunk is finished, in loop_next() or loop_end()
+void xomp_native_ordered_end (void)
+{
+}
+
+//---------------------------------------------
+// Sections and single
+
+int xomp_native_sections_start (int section_count)
+{
+  struct xomp_member *m = current_member();
+  bool first;
+  struct xomp_ws *ws = ws_enter(m, &first);
+  if (first)
+  {
+    ws->n = section_count;
+    ws->next = 0;
+    ws_publish(ws);
+  }
+  return xomp_native_sections_next();
+}
+
+int xomp_native_sections_next (void)
+{
+  struct xomp_member *m = current_member();
+  if (m->ws == NULL)
+    return -1;
+  long id = __atomic_fetch_add(&m->ws->next, 1, __ATOMIC_RELAXED);
+  return id < m->ws->n ? (int)id : -1;
+}
+
+void xomp_native_sections_end (bool nowait)
+{
+  struct xomp_member *m = current_member();
+  ws_leave(m);
+  if (!nowait)
+    team_barrier(m);
+}
+
+bool xomp_native_single (void)
+{
+  struct xomp_member *m = current_member();
+  bool first;
+  struct xomp_ws *ws = ws_enter(m, &first);
+  if (first)
+    ws_publish(ws);
+  ws_leave(m);
+  return first;
+}
+
+//---------------------------------------------
+// Mutual exclusion
+
+// *data names a critical section. Its mutex is created on first use.
+static pthread_mutex_t* critical_lock (void **data)
+{
+  if (data == NULL)
+    return &xomp_critical_lock;
+  pthread_mutex_t *lock = (pthread_mutex_t*) __atomic_load_n(data, __ATOMIC_ACQUIRE);
+  if (lock == NULL)
+  {
+    pthread_mutex_t *fresh = (pthread_mutex_t*) malloc(sizeof(pthread_mutex_t));
+    void *expected = NULL;
+    assert(fresh != NULL);
+    pthread_mutex_init(fresh, NULL);
+    if (__atomic_compare_exchange_n(data, &expected, (void*)fresh, false, __ATOMIC_ACQ_REL, __ATOMIC_ACQUIRE))
+      lock = fresh;
+    else
+    {
+      pthread_mutex_destroy(fresh);
+      free(fresh);
+      lock = (pthread_mutex_t*) expected;
+    }
+  }
+  return lock;
+}
+
+void xomp_native_critical_start (void **data)
+{
+  pthread_mutex_lock(critical_lock(data));
+}
+
+void xomp_native_critical_end (void **data)
+{
+  pthread_mutex_unlock(critical_lock(data));
+}
+
+void xomp_native_atomic_start (void)
+{
+  pthread_mutex_lock(&xomp_atomic_lock);
+}
+
+void xomp_native_atomic_end (void)
+{
+  pthread_mutex_unlock(&xomp_atomic_lock);
+}
+
+//---------------------------------------------
+// OpenMP locks. A simple lock is one int and a nestable lock adds a nesting count and the owning task, so they fit in
+// the storage of GOMP's omp_lock_t and omp_nest_lock_t and translated code can keep using the compiler's omp.h.
+
+struct xomp_nest_lock
+{
+  int lock;
+  int count;
+  void *owner;
+};
+
+static bool simple_lock_try (int *lock)
+{
+  int expected = 0;
+  return __atomic_load_n(lock, __ATOMIC_RELAXED) == 0 &&
+         __atomic_compare_exchange_n(lock, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED);
+}
+
+void xomp_native_init_lock (void *lock)
+{
+  __atomic_store_n((int*)lock, 0, __ATOMIC_RELEASE);
+}
+
+void xomp_native_destroy_lock (void *lock)
+{
+  assert(__atomic_load_n((int*)lock, __ATOMIC_RELAXED) == 0);
+}
+
+void xomp_native_set_lock (void *lock)
+{
+  unsigned spins = 0;
+  while (!simple_lock_try((int*)lock))
+    xomp_backoff(&spins);
+}
+
+void xomp_native_unset_lock (void *lock)
+{
+  __atomic_store_n((int*)lock, 0, __ATOMIC_RELEASE);
+}
+
+bool xomp_native_test_lock (void *lock)
+{
+  return simple_lock_try((int*)lock);
+}
+
+void xomp_native_init_nest_lock (void *lock)
+{
+  struct xomp_nest_lock *l = (struct xomp_nest_lock*) lock;
+  l->count = 0;
+  l->owner = NULL;
+  __atomic_store_n(&l->lock, 0, __ATOMIC_RELEASE);
+}
+
+void xomp_native_destroy_nest_lock (void *lock)
+{
+  assert(((struct xomp_nest_lock*)lock)->count == 0);
+}
+
+// Only the owning task reads or writes count and owner while the lock is held
+int xomp_native_test_nest_lock (void *lock)
+{
+  struct xomp_nest_lock *l = (struct xomp_nest_lock*) lock;
+  void *self = current_member()->task;
+  if (__atomic_load_n(&l->owner, __ATOMIC_RELAXED) == self)
+    return ++l->count;
+  if (!simple_lock_try(&l->lock))
+    return 0;
+  __atomic_store_n(&l->owner, self, __ATOMIC_RELAXED);
+  l->count = 1;
+  return 1;
+}
+
+void xomp_native_set_nest_lock (void *lock)
+{
+  unsigned spins = 0;
+  while (xomp_native_test_nest_lock(lock) == 0)
+    xomp_backoff(&spins);
+}
+
+void xomp_native_unset_nest_lock (void *lock)
+{
+  struct xomp_nest_lock *l = (struct xomp_nest_lock*) lock;
+  assert(l->owner == current_member()->task && l->count > 0);
+  if (--l->count == 0)
+  {
+    __atomic_store_n(&l->owner, NULL, __ATOMIC_RELAXED);
+    __atomic_store_n(&l->lock, 0, __ATOMIC_RELEASE);
+  }
+}
@@ -0,0 +1,102 @@
+/*
+ * A native runtime behind the XOMP interface, used instead of GOMP or Omni
+ * when USE_ROSE_NATIVE_XOMP_RUNTIME is defined. xomp.c forwards to the
+ * functions declared here.
+ *
+ * - A persistent pthread pool forms the team of each outermost parallel region.
+ *   Nested (or concurrent) regions are serialized on a team of one thread.
+ * - Each thread owns a Chase-Lev work-stealing deque for explicit tasks. Idle
+ *   threads, and threads waiting in taskwait or a barrier, steal from others.
+ * - Dynamic and guided loops are self-scheduled: threads claim chunks with a
+ *   single atomic operation on a per-construct iteration counter.
+ * - Threads can be pinned to CPUs, in NUMA node order.
+ *
+ * Environment variables:
+ *   XOMP_NUM_THREADS or OMP_NUM_THREADS: default team size (default: online CPUs)
+ *   XOMP_PROC_BIND or OMP_PROC_BIND: false (default) leaves threads unpinned;
+ *       true|close fill the CPUs of one NUMA node before using the next;
+ *       spread places consecutive threads on different NUMA nodes
+ *   OMP_SCHEDULE: schedule of the runtime loop functions, e.g. "guided,4" (default: dynamic,1)
+ *
+ * Loop bounds follow GOMP: the end bound is non-inclusive.
+ *
+ * xomp_native_sched_test.c checks and times this runtime against GOMP.
+ */
+#ifndef XOMP_NATIVE_H
+#define XOMP_NATIVE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdbool.h>
+
+enum xomp_native_sched
+{
+  XOMP_NATIVE_STATIC,
+  XOMP_NATIVE_DYNAMIC,
+  XOMP_NATIVE_GUIDED,
+  XOMP_NATIVE_RUNTIME
+};
+
+// Read the environment and create the thread pool. Optional: the first parallel region does it otherwise.
+extern void xomp_native_init (void);
+// Join the thread pool. Must not be called inside a parallel region.
+extern void xomp_native_terminate (void);
+
+// Start a parallel region of numThreads threads (0 for the default) on which func(data) runs.
+// Like GOMP_parallel_start(), the calling thread runs func(data) itself after this returns.
+extern void xomp_native_parallel_start (void (*func) (void *), void *data, unsigned numThreads);
+extern void xomp_native_parallel_end (void);
+
+extern int xomp_native_thread_num (void);
+extern int xomp_native_num_threads (void);
+extern int xomp_native_max_threads (void);
+extern void xomp_native_set_num_threads (int n);
+extern bool xomp_native_in_parallel (void);
+
+// A barrier also waits for all explicit tasks of the team to complete
+extern void xomp_native_barrier (void);
+
+// Untied tasks are treated as tied
+extern void xomp_native_task (void (*fn) (void *), void *data, void (*cpyfn) (void *, void *),
+                              long arg_size, long arg_align, bool if_clause);
+extern void xomp_native_taskwait (void);
+
+// chunk_size <= 0 for a static schedule divides the iterations evenly among threads
+extern bool xomp_native_loop_start (enum xomp_native_sched sched, bool ordered, long start, long end, long incr,
+                                    long chunk_size, long *istart, long *iend);
+extern bool xomp_native_loop_next (long *istart, long *iend);
+extern void xomp_native_loop_end (bool nowait);
+extern void xomp_native_ordered_start (void);
+extern void xomp_native_ordered_end (void);
+
+// Section ids start from 0. A negative id means no sections are left.
+extern int xomp_native_sections_start (int section_count);
+extern int xomp_native_sections_next (void);
+extern void xomp_native_sections_end (bool nowait);
+
+extern bool xomp_native_single (void);
+extern void xomp_native_critical_start (void **data);
+extern void xomp_native_critical_end (void **data);
+extern void xomp_native_atomic_start (void);
+extern void xomp_native_atomic_end (void);
+
+// OpenMP lock routines. The locks fit in the storage of GOMP's omp_lock_t and omp_nest_lock_t, and nestable locks are
+// owned by tasks. The test functions return whether the lock was acquired, or the new nesting count.
+extern void xomp_native_init_lock (void *lock);
+extern void xomp_native_destroy_lock (void *lock);
+extern void xomp_native_set_lock (void *lock);
+extern void xomp_native_unset_lock (void *lock);
+extern bool xomp_native_test_lock (void *lock);
+extern void xomp_native_init_nest_lock (void *lock);
+extern void xomp_native_destroy_nest_lock (void *lock);
+extern void xomp_native_set_nest_lock (void *lock);
+extern void xomp_native_unset_nest_lock (void *lock);
+extern int xomp_native_test_nest_lock (void *lock);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XOMP_NATIVE_H */
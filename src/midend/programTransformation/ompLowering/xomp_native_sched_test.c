@@ -0,0 +1,320 @@
+// A self-contained test of the native XOMP runtime's loop scheduling and tasking, timed against GOMP.
+// The outlined functions mimic what the OpenMP lowering generates.
+// Compile : gcc -O2 -fopenmp xomp_native_sched_test.c xomp_native.c -lpthread
+// Run     : ./a.out [threads]
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <omp.h>
+#include <assert.h>
+#include "xomp_native.h"
+
+#define SIZE 1000000
+#define FIB_N 27
+#define REPEAT 5
+
+int a[SIZE], b[SIZE];
+int n_threads = 4;
+
+// Uneven work per iteration, so that dynamic and guided scheduling matter
+static int work (int i)
+{
+  int k, sum = 0;
+  for (k = 0; k < (i % 64); k++)
+    sum += k ^ i;
+  return sum;
+}
+
+//---------------------------------------------
+// Loops: for (i = 0; i <= SIZE-1; i++) b[i] += work(i);
+struct loop_args
+{
+  enum xomp_native_sched sched;
+  long chunk;
+  bool ordered;
+  long last;  // ordered: the last iteration seen in an ordered region
+};
+
+static void OUT__1__loop__ (void *data)
+{
+  struct loop_args *args = (struct loop_args*) data;
+  long lower, upper, i;
+  // the non-inclusive end bound, as XOMP_loop_*_start() passes it on
+  if (xomp_native_loop_start (args->sched, args->ordered, 0, SIZE, 1, args->chunk, &lower, &upper))
+  {
+    do
+    {
+      for (i = lower; i < upper; i++)
+      {
+        b[i] += work(i);
+        if (args->ordered)
+        {
+          xomp_native_ordered_start();
+          assert (args->last == i - 1);
+          args->last = i;
+          xomp_native_ordered_end();
+        }
+      }
+    }
+    while (xomp_native_loop_next (&lower, &upper));
+  }
+  xomp_native_loop_end (false);
+}
+
+static double run_native_loop (enum xomp_native_sched sched, long chunk, bool ordered)
+{
+  struct loop_args args = {sched, chunk, ordered, -1};
+  int i;
+  for (i = 0; i < SIZE; i++)
+    b[i] = 0;
+  double t = omp_get_wtime();
+  xomp_native_parallel_start (OUT__1__loop__, &args, n_threads);
+  OUT__1__loop__ (&args);
+  xomp_native_parallel_end ();
+  t = omp_get_wtime() - t;
+  for (i = 0; i < SIZE; i++)
+    assert (a[i] == b[i]);
+  if (ordered)
+    assert (args.last == SIZE - 1);
+  return t;
+}
+
+static double run_gomp_loop (enum xomp_native_sched sched, long chunk)
+{
+  int i;
+  for (i = 0; i < SIZE; i++)
+    b[i] = 0;
+  double t = omp_get_wtime();
+  if (sched == XOMP_NATIVE_DYNAMIC)
+  {
+#pragma omp parallel for schedule(dynamic, chunk) num_threads(n_threads)
+    for (i = 0; i < SIZE; i++)
+      b[i] += work(i);
+  }
+  else if (sched == XOMP_NATIVE_GUIDED)
+  {
+#pragma omp parallel for schedule(guided, chunk) num_threads(n_threads)
+    for (i = 0; i < SIZE; i++)
+      b[i] += work(i);
+  }
+  else
+  {
+#pragma omp parallel for schedule(static, chunk) num_threads(n_threads)
+    for (i = 0; i < SIZE; i++)
+      b[i] += work(i);
+  }
+  t = omp_get_wtime() - t;
+  for (i = 0; i < SIZE; i++)
+    assert (a[i] == b[i]);
+  return t;
+}
+
+//---------------------------------------------
+// Tasks: recursive Fibonacci, one task per call
+struct fib_args
+{
+  int n;
+  long *result;
+};
+
+static void OUT__2__fib__ (void *data);
+
+static long native_fib (int n)
+{
+  long x, y;
+  struct fib_args args;
+  if (n < 2)
+    return n;
+  args.n = n - 1;
+  args.result = &x;
+  xomp_native_task (OUT__2__fib__, &args, NULL, sizeof args, sizeof(void*), true);
+  args.n = n - 2;
+  args.result = &y;
+  xomp_native_task (OUT__2__fib__, &args, NULL, sizeof args, sizeof(void*), true);
+  xomp_native_taskwait ();
+  return x + y;
+}
+
+static void OUT__2__fib__ (void *data)
+{
+  struct fib_args *args = (struct fib_args*) data;
+  *args->result = native_fib (args->n);
+}
+
+static long fib_result;
+
+static void OUT__3__fib_single__ (void *data)
+{
+  (void) data;
+  if (xomp_native_single ())
+    fib_result = native_fib (FIB_N);
+  xomp_native_barrier ();
+}
+
+static long gomp_fib (int n)
+{
+  long x, y;
+  if (n < 2)
+    return n;
+#pragma omp task shared(x)
+  x = gomp_fib (n - 1);
+#pragma omp task shared(y)
+  y = gomp_fib (n - 2);
+#pragma omp taskwait
+  return x + y;
+}
+
+static long serial_fib (int n)
+{
+  return n < 2 ? n : serial_fib (n - 1) + serial_fib (n - 2);
+}
+
+//---------------------------------------------
+// Sections and single: each section and each single block runs exactly once
+static int section_hits[7];
+static int single_hits;
+
+static void OUT__4__sections__ (void *data)
+{
+  int id, k;
+  (void) data;
+  for (id = xomp_native_sections_start (7); id >= 0; id = xomp_native_sections_next ())
+    __atomic_add_fetch (&section_hits[id], 1, __ATOMIC_RELAXED);
+  xomp_native_sections_end (true);
+  for (k = 0; k < 100; k++)
+  {
+    if (xomp_native_single ())
+      __atomic_add_fetch (&single_hits, 1, __ATOMIC_RELAXED);
+  }
+  xomp_native_barrier ();
+}
+
+//---------------------------------------------
+// Locks: the native lock routines must work on the storage of omp.h's lock types
+#define LOCK_ROUNDS 10000
+static omp_lock_t simple_lock;
+static omp_nest_lock_t nest_lock;
+static long simple_count, nest_count;
+
+static void OUT__5__locks__ (void *data)
+{
+  int k;
+  (void) data;
+  for (k = 0; k < LOCK_ROUNDS; k++)
+  {
+    xomp_native_set_lock (&simple_lock);
+    simple_count++;
+    xomp_native_unset_lock (&simple_lock);
+
+    xomp_native_set_nest_lock (&nest_lock);
+    assert (xomp_native_test_nest_lock (&nest_lock) == 2);
+    nest_count++;
+    xomp_native_unset_nest_lock (&nest_lock);
+    xomp_native_unset_nest_lock (&nest_lock);
+  }
+}
+
+// Many short regions in a row: a region must not start while threads of the previous one are still leaving it
+static int region_hits;
+
+static void OUT__6__short__ (void *data)
+{
+  (void) data;
+  __atomic_add_fetch (&region_hits, 1, __ATOMIC_RELAXED);
+  xomp_native_barrier ();
+}
+
+int main (int argc, char *argv[])
+{
+  int i, r;
+  if (argc > 1)
+    n_threads = atoi (argv[1]);
+  assert (n_threads > 0);
+  xomp_native_init ();
+
+  for (i = 0; i < SIZE; i++)
+    a[i] = work (i);
+
+  enum xomp_native_sched scheds[] = {XOMP_NATIVE_STATIC, XOMP_NATIVE_DYNAMIC, XOMP_NATIVE_GUIDED};
+  const char *names[] = {"static", "dynamic", "guided"};
+  long chunks[] = {1, 16, 1024};
+  int s, c;
+  printf ("%d threads, times in seconds (best of %d)\n", n_threads, REPEAT);
+  printf ("%-8s %6s %10s %10s\n", "schedule", "chunk", "native", "gomp");
+  for (s = 0; s < 3; s++)
+  {
+    for (c = 0; c < 3; c++)
+    {
+      double tn = 1e9, tg = 1e9;
+      for (r = 0; r < REPEAT; r++)
+      {
+        double t = run_native_loop (scheds[s], chunks[c], false);
+        tn = t < tn ? t : tn;
+        t = run_gomp_loop (scheds[s], chunks[c]);
+        tg = t < tg ? t : tg;
+      }
+      printf ("%-8s %6ld %10.6f %10.6f\n", names[s], chunks[c], tn, tg);
+    }
+  }
+
+  // correctness only
+  run_native_loop (XOMP_NATIVE_STATIC, 0, false);
+  run_native_loop (XOMP_NATIVE_RUNTIME, 0, false);
+  run_native_loop (XOMP_NATIVE_STATIC, 7, true);
+  run_native_loop (XOMP_NATIVE_DYNAMIC, 100, true);
+  run_native_loop (XOMP_NATIVE_GUIDED, 3, true);
+
+  xomp_native_parallel_start (OUT__4__sections__, NULL, n_threads);
+  OUT__4__sections__ (NULL);
+  xomp_native_parallel_end ();
+  for (i = 0; i < 7; i++)
+    assert (section_hits[i] == 1);
+  assert (single_hits == 100);
+
+  xomp_native_init_lock (&simple_lock);
+  xomp_native_init_nest_lock (&nest_lock);
+  xomp_native_parallel_start (OUT__5__locks__, NULL, n_threads);
+  OUT__5__locks__ (NULL);
+  xomp_native_parallel_end ();
+  assert (xomp_native_test_lock (&simple_lock));
+  xomp_native_unset_lock (&simple_lock);
+  xomp_native_destroy_lock (&simple_lock);
+  xomp_native_destroy_nest_lock (&nest_lock);
+  assert (simple_count == (long)n_threads * LOCK_ROUNDS);
+  assert (nest_count == (long)n_threads * LOCK_ROUNDS);
+
+  for (r = 0; r < 1000; r++)
+  {
+    xomp_native_parallel_start (OUT__6__short__, NULL, n_threads);
+    OUT__6__short__ (NULL);
+    xomp_native_parallel_end ();
+  }
+  assert (region_hits == 1000 * n_threads);
+
+  long expected = serial_fib (FIB_N);
+  double tn = 1e9, tg = 1e9;
+  for (r = 0; r < REPEAT; r++)
+  {
+    double t = omp_get_wtime();
+    fib_result = 0;
+    xomp_native_parallel_start (OUT__3__fib_single__, NULL, n_threads);
+    OUT__3__fib_single__ (NULL);
+    xomp_native_parallel_end ();
+    t = omp_get_wtime() - t;
+    assert (fib_result == expected);
+    tn = t < tn ? t : tn;
+
+    t = omp_get_wtime();
+#pragma omp parallel num_threads(n_threads)
+#pragma omp single
+    fib_result = gomp_fib (FIB_N);
+    t = omp_get_wtime() - t;
+    assert (fib_result == expected);
+    tg = t < tg ? t : tg;
+  }
+  printf ("%-8s %6d %10.6f %10.6f\n", "fib task", FIB_N, tn, tg);
+
+  xomp_native_terminate ();
+  printf ("Success if you see this printf output!\n");
+  return 0;
+}
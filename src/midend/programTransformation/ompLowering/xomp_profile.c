@@ -0,0 +1,308 @@
+// Per-region, per-thread profiling of XOMP parallel regions. See xomp_profile.h.
+#ifndef _GNU_SOURCE
+#define _GNU_SOURCE // for syscall()
+#endif
+
+#include "xomp_profile.h"
+
+#include <assert.h>
+#include <stdbool.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+#include <time.h>
+#include <unistd.h>
+
+#ifdef __linux__
+#include <linux/perf_event.h>
+#include <sys/syscall.h>
+#endif
+
+// avoid include omp.h
+extern int omp_get_thread_num(void);
+extern char* current_time_to_str(void);
+
+#define XOMP_PROFILE_MAX_THREADS 256
+
+struct xomp_profile_region_state
+{
+  void (*func) (void *);        // the outlined function being timed
+  void *data;
+  uint32_t id;
+  double start;
+  int nthreads;                 // one more than the largest thread number seen
+  struct xomp_profile_thread threads[XOMP_PROFILE_MAX_THREADS];
+};
+
+struct xomp_profile_location
+{
+  char *file_name;
+  int line_no;
+};
+
+static FILE *xomp_profile_fp = NULL;
+static bool xomp_profile_counters = false;
+static struct timespec xomp_profile_epoch;
+static struct xomp_profile_region_state xomp_profile_state;
+static int xomp_profile_busy = 0;       // a region is being profiled
+static struct xomp_profile_location *xomp_profile_locations = NULL;
+static uint32_t xomp_profile_nlocations = 0;
+
+static __thread struct xomp_profile_thread *xomp_profile_current = NULL; // this thread's record in the region
+static __thread bool xomp_profile_owner = false;                         // this thread started the region
+static __thread int xomp_profile_fd = -2;                                // counter group: -2 not opened, -1 unavailable
+static __thread unsigned xomp_profile_fd_session = 0;                    // xomp_profile_session when the group was opened
+
+// Every thread's counter group (leader and member), so that xomp_profile_finish() can close them
+static int xomp_profile_fds[2 * XOMP_PROFILE_MAX_THREADS];
+static int xomp_profile_nfds = 0;
+static unsigned xomp_profile_session = 0;       // incremented each time profiling is turned on
+
+static double now (void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return (t.tv_sec - xomp_profile_epoch.tv_sec) + 1.0e-9 * (t.tv_nsec - xomp_profile_epoch.tv_nsec);
+}
+
+//---------------------------------------------
+// Hardware counters: one perf_event group per thread, cycles as leader and cache misses as member
+
+#ifdef __linux__
+static int perf_open (uint64_t config, int group_fd)
+{
+  struct perf_event_attr attr;
+  memset(&attr, 0, sizeof attr);
+  attr.size = sizeof attr;
+  attr.type = PERF_TYPE_HARDWARE;
+  attr.config = config;
+  attr.exclude_kernel = 1;
+  attr.exclude_hv = 1;
+  attr.read_format = PERF_FORMAT_GROUP;
+  return (int) syscall(__NR_perf_event_open, &attr, 0, -1, group_fd, 0);
+}
+#endif
+
+static bool counters_read (uint64_t values[2])
+{
+  if (!xomp_profile_counters)
+    return false;
+#ifdef __linux__
+  if (xomp_profile_fd_session != xomp_profile_session)
+  {
+    xomp_profile_fd = -2;       // opened while profiling was on before, and closed since then
+    xomp_profile_fd_session = xomp_profile_session;
+  }
+  if (xomp_profile_fd == -2)
+  {
+    int leader = -1;
+    int slot = __atomic_fetch_add(&xomp_profile_nfds, 2, __ATOMIC_RELAXED);
+    if (slot + 2 <= 2 * XOMP_PROFILE_MAX_THREADS)   // otherwise there would be no way to close them
+    {
+      int member = -1;
+      leader = perf_open(PERF_COUNT_HW_CPU_CYCLES, -1);
+      if (leader >= 0 && (member = perf_open(PERF_COUNT_HW_CACHE_MISSES, leader)) < 0)
+      {
+        close(leader);
+        leader = -1;
+      }
+      xomp_profile_fds[slot] = leader;
+      xomp_profile_fds[slot + 1] = member;
+    }
+    xomp_profile_fd = leader;
+  }
+  if (xomp_profile_fd >= 0)
+  {
+    uint64_t group[3];          // number of counters, then their values
+    if (read(xomp_profile_fd, group, sizeof group) == sizeof group && group[0] == 2)
+    {
+      values[0] = group[1];
+      values[1] = group[2];
+      return true;
+    }
+  }
+#endif
+  return false;
+}
+
+//---------------------------------------------
+// Log
+
+static void write_record (enum xomp_profile_record_kind kind, const void *record, size_t size)
+{
+  uint8_t k = (uint8_t) kind;
+  fwrite(&k, 1, 1, xomp_profile_fp);
+  fwrite(record, size, 1, xomp_profile_fp);
+}
+
+// Number a source location, logging it the first time it is seen
+static uint32_t region_id (const char *file_name, int line_no)
+{
+  uint32_t i;
+  if (file_name == NULL)
+    file_name = "";
+  for (i = 0; i < xomp_profile_nlocations; i++)
+  {
+    if (xomp_profile_locations[i].line_no == line_no && strcmp(xomp_profile_locations[i].file_name, file_name) == 0)
+      return i;
+  }
+
+  xomp_profile_locations = (struct xomp_profile_location*)
+    realloc(xomp_profile_locations, (xomp_profile_nlocations + 1) * sizeof(struct xomp_profile_location));
+  assert(xomp_profile_locations != NULL);
+  xomp_profile_locations[i].file_name = strdup(file_name);
+  xomp_profile_locations[i].line_no = line_no;
+  xomp_profile_nlocations++;
+
+  struct xomp_profile_region region;
+  region.id = i;
+  region.line = line_no;
+  region.name_length = (uint32_t) strlen(file_name);
+  region.reserved = 0;
+  write_record(XOMP_PROFILE_REGION, &region, sizeof region);
+  fwrite(file_name, 1, region.name_length, xomp_profile_fp);
+  return i;
+}
+
+void xomp_profile_init (void)
+{
+  const char *value = getenv("XOMP_REGION_PROFILE");
+  if (xomp_profile_fp != NULL || value == NULL || value[0] == '\0' || strcmp(value, "0") == 0)
+    return;
+
+  char *generated = NULL;
+  if (strcmp(value, "1") == 0)
+  {
+    char *timestamp = current_time_to_str();
+    generated = (char*) malloc(strlen(timestamp) + 32);
+    assert(generated != NULL);
+    sprintf(generated, "xomp_profile_%s.bin", timestamp);
+    free(timestamp);
+    value = generated;
+  }
+  xomp_profile_fp = fopen(value, "wb");
+  if (xomp_profile_fp == NULL)
+  {
+    fprintf(stderr, "XOMP region profiling: cannot open %s\n", value);
+    free(generated);
+    return;
+  }
+  printf("XOMP region profiling is turned on, writing %s ...\n", value);
+  free(generated);
+
+  value = getenv("XOMP_REGION_PROFILE_COUNTERS");
+  xomp_profile_counters = value != NULL && strcmp(value, "1") == 0;
+  xomp_profile_session++;
+
+  struct xomp_profile_header header;
+  memcpy(header.magic, XOMP_PROFILE_MAGIC, sizeof header.magic);
+  header.version = XOMP_PROFILE_VERSION;
+  header.flags = xomp_profile_counters ? XOMP_PROFILE_HAS_COUNTERS : 0;
+  fwrite(&header, sizeof header, 1, xomp_profile_fp);
+
+  clock_gettime(CLOCK_MONOTONIC, &xomp_profile_epoch);
+  atexit(xomp_profile_finish);  // in case XOMP_terminate() is never called
+}
+
+void xomp_profile_finish (void)
+{
+  if (xomp_profile_fp == NULL)
+    return;
+  fclose(xomp_profile_fp);
+  xomp_profile_fp = NULL;
+
+#ifdef __linux__
+  // No region is running, so no thread is using its counter group
+  int i, nfds = __atomic_exchange_n(&xomp_profile_nfds, 0, __ATOMIC_ACQUIRE);
+  if (nfds > 2 * XOMP_PROFILE_MAX_THREADS)
+    nfds = 2 * XOMP_PROFILE_MAX_THREADS;
+  for (i = 0; i < nfds; i++)
+  {
+    if (xomp_profile_fds[i] >= 0)
+      close(xomp_profile_fds[i]);
+  }
+#endif
+  xomp_profile_counters = false;
+}
+
+//---------------------------------------------
+// Regions
+
+// Runs on every thread of the team in place of the outlined function
+static void xomp_profile_run (void *arg)
+{
+  struct xomp_profile_region_state *r = (struct xomp_profile_region_state*) arg;
+  int tid = omp_get_thread_num();
+  if (tid < 0 || tid >= XOMP_PROFILE_MAX_THREADS)
+  {
+    r->func(r->data);
+    return;
+  }
+
+  struct xomp_profile_thread *t = &r->threads[tid];
+  uint64_t before[2], after[2];
+  bool counting = counters_read(before);
+  t->begin = now() - r->start;
+  xomp_profile_current = t;
+  r->func(r->data);
+  xomp_profile_current = NULL;
+  t->end = now() - r->start;
+  if (counting && counters_read(after))
+  {
+    t->cycles = after[0] - before[0];
+    t->cache_misses = after[1] - before[1];
+  }
+
+  int seen = __atomic_load_n(&r->nthreads, __ATOMIC_RELAXED);
+  while (seen < tid + 1 &&
+         !__atomic_compare_exchange_n(&r->nthreads, &seen, tid + 1, true, __ATOMIC_RELEASE, __ATOMIC_RELAXED))
+    ;
+}
+
+void xomp_profile_region_start (void (**func) (void *), void **data, const char *file_name, int line_no)
+{
+  int expected = 0;
+  if (xomp_profile_fp == NULL || xomp_profile_current != NULL)
+    return;                     // off, or nested in a profiled region
+  if (!__atomic_compare_exchange_n(&xomp_profile_busy, &expected, 1, false, __ATOMIC_ACQUIRE, __ATOMIC_RELAXED))
+    return;                     // another thread's region is being profiled
+
+  struct xomp_profile_region_state *r = &xomp_profile_state;
+  memset(r->threads, 0, sizeof r->threads);
+  r->func = *func;
+  r->data = *data;
+  r->id = region_id(file_name, line_no);
+  r->nthreads = 0;
+  r->start = now();
+  xomp_profile_owner = true;
+  *func = xomp_profile_run;
+  *data = r;
+}
+
+void xomp_profile_region_end (void)
+{
+  if (!xomp_profile_owner || xomp_profile_current != NULL)
+    return;                     // not profiled, or the end of a nested region
+  struct xomp_profile_region_state *r = &xomp_profile_state;
+  struct xomp_profile_instance instance;
+  instance.end = now();
+  instance.id = r->id;
+  instance.nthreads = (uint32_t) __atomic_load_n(&r->nthreads, __ATOMIC_ACQUIRE);
+  instance.start = r->start;
+  write_record(XOMP_PROFILE_INSTANCE, &instance, sizeof instance);
+  fwrite(r->threads, sizeof(struct xomp_profile_thread), instance.nthreads, xomp_profile_fp);
+
+  xomp_profile_owner = false;
+  __atomic_store_n(&xomp_profile_busy, 0, __ATOMIC_RELEASE);
+}
+
+double xomp_profile_barrier_begin (void)
+{
+  return xomp_profile_current != NULL ? now() : 0.0;
+}
+
+void xomp_profile_barrier_end (double begin)
+{
+  if (xomp_profile_current != NULL)
+    xomp_profile_current->barrier += now() - begin;
+}
@@ -0,0 +1,85 @@
+/*
+ * Per-region profiling of XOMP parallel regions, turned on at run time with
+ *   XOMP_REGION_PROFILE=<file>          binary log to write ("1" picks a time-stamped name)
+ *   XOMP_REGION_PROFILE_COUNTERS=1      also count cycles and cache misses with perf_event_open(2)
+ *
+ * Every instance of an outermost parallel region records, for each thread,
+ * when it entered and left the outlined function, how long it waited in
+ * barriers (XOMP_barrier(), and the barriers of loops and sections), and
+ * optionally its hardware counter deltas. Times come from CLOCK_MONOTONIC.
+ * Nested regions are accounted to their enclosing region.
+ *
+ * xomp_profile_summary.c reads the log and prints per-region totals,
+ * imbalance and barrier time.
+ *
+ * Log layout (native byte order): a xomp_profile_header, then records each
+ * starting with a one-byte xomp_profile_record_kind:
+ *   XOMP_PROFILE_REGION:   xomp_profile_region, then name_length bytes of file name
+ *   XOMP_PROFILE_INSTANCE: xomp_profile_instance, then nthreads xomp_profile_thread
+ */
+#ifndef XOMP_PROFILE_H
+#define XOMP_PROFILE_H
+
+#ifdef __cplusplus
+extern "C" {
+#endif
+
+#include <stdint.h>
+
+#define XOMP_PROFILE_MAGIC "XOMPPRF1"
+#define XOMP_PROFILE_VERSION 1
+#define XOMP_PROFILE_HAS_COUNTERS 0x1  // xomp_profile_header flags
+
+enum xomp_profile_record_kind
+{
+  XOMP_PROFILE_REGION = 1,      // first time a region (source location) is seen
+  XOMP_PROFILE_INSTANCE = 2     // one execution of a region
+};
+
+struct xomp_profile_header
+{
+  char magic[8];
+  uint32_t version;
+  uint32_t flags;
+};
+
+struct xomp_profile_region
+{
+  uint32_t id;
+  int32_t line;
+  uint32_t name_length;
+  uint32_t reserved;
+};
+
+struct xomp_profile_instance
+{
+  uint32_t id;
+  uint32_t nthreads;
+  double start;                 // seconds since profiling began
+  double end;
+};
+
+struct xomp_profile_thread
+{
+  double begin;                 // seconds since the instance started
+  double end;
+  double barrier;               // seconds spent waiting in barriers inside the region
+  uint64_t cycles;              // 0 when counters are off or unavailable
+  uint64_t cache_misses;
+};
+
+// Runtime side, called from xomp.c
+extern void xomp_profile_init (void);
+extern void xomp_profile_finish (void);
+// Replaces func and data by a wrapper that times each thread, if this is an outermost region and profiling is on
+extern void xomp_profile_region_start (void (**func) (void *), void **data, const char *file_name, int line_no);
+extern void xomp_profile_region_end (void);
+// Bracket a barrier. Cheap when profiling is off.
+extern double xomp_profile_barrier_begin (void);
+extern void xomp_profile_barrier_end (double begin);
+
+#ifdef __cplusplus
+}
+#endif
+
+#endif /* XOMP_PROFILE_H */
@@ -0,0 +1,176 @@
+// Summarize a log written by XOMP region profiling (XOMP_REGION_PROFILE=<file>, see xomp_profile.h)
+// Usage: xompProfileSummary <file>
+//
+// For each parallel region, in decreasing order of total time:
+//   count     number of times the region ran
+//   total     wall time summed over all instances, seconds
+//   mean      wall time per instance, seconds
+//   imbal     mean over instances of max/min thread work, where a thread's work is the time it spent in the
+//             outlined function less its barrier waits. 1.00 is perfectly balanced.
+//   barrier   share of thread time spent waiting, both in barriers inside the region and at its end
+//   Mcycles   cycles summed over threads, in millions (with XOMP_REGION_PROFILE_COUNTERS=1)
+//   miss/Kc   cache misses per thousand cycles
+#include "xomp_profile.h"
+
+#include <stdio.h>
+#include <stdlib.h>
+#include <string.h>
+
+struct region_summary
+{
+  char *file_name;
+  int line;
+  unsigned long count;
+  double total;                 // wall time of all instances
+  double imbalance;             // sum over instances of max/min thread work
+  unsigned long nbalanced;      // instances with a defined imbalance
+  double thread_time;           // thread time of all instances: wall time times number of threads
+  double wait;                  // waiting part of thread_time
+  double cycles;
+  double cache_misses;
+};
+
+static struct region_summary *regions = NULL;
+static size_t nregions = 0;
+
+static struct region_summary* region (uint32_t id)
+{
+  if (id >= nregions)
+  {
+    regions = (struct region_summary*) realloc(regions, (id + 1) * sizeof(struct region_summary));
+    if (regions == NULL)
+    {
+      fprintf(stderr, "out of memory\n");
+      exit(1);
+    }
+    memset(regions + nregions, 0, (id + 1 - nregions) * sizeof(struct region_summary));
+    nregions = id + 1;
+  }
+  return &regions[id];
+}
+
+static int by_total (const void *a, const void *b)
+{
+  double x = ((const struct region_summary*) a)->total, y = ((const struct region_summary*) b)->total;
+  return x < y ? 1 : x > y ? -1 : 0;
+}
+
+static void truncated (const char *file_name)
+{
+  fprintf(stderr, "%s: truncated or corrupt profile\n", file_name);
+  exit(1);
+}
+
+int main (int argc, char *argv[])
+{
+  if (argc != 2)
+  {
+    fprintf(stderr, "usage: %s <profile>\n", argv[0]);
+    return 1;
+  }
+  FILE *f = fopen(argv[1], "rb");
+  if (f == NULL)
+  {
+    perror(argv[1]);
+    return 1;
+  }
+
+  struct xomp_profile_header header;
+  if (fread(&header, sizeof header, 1, f) != 1 || memcmp(header.magic, XOMP_PROFILE_MAGIC, sizeof header.magic) != 0 ||
+      header.version != XOMP_PROFILE_VERSION)
+  {
+    fprintf(stderr, "%s: not an XOMP profile (version %d)\n", argv[1], XOMP_PROFILE_VERSION);
+    return 1;
+  }
+
+  struct xomp_profile_thread *threads = NULL;
+  size_t nallocated = 0;
+  uint8_t kind;
+  while (fread(&kind, 1, 1, f) == 1)
+  {
+    if (kind == XOMP_PROFILE_REGION)
+    {
+      struct xomp_profile_region r;
+      if (fread(&r, sizeof r, 1, f) != 1)
+        truncated(argv[1]);
+      struct region_summary *s = region(r.id);
+      free(s->file_name);
+      s->file_name = (char*) malloc(r.name_length + 1);
+      if (s->file_name == NULL || fread(s->file_name, 1, r.name_length, f) != r.name_length)
+        truncated(argv[1]);
+      s->file_name[r.name_length] = '\0';
+      s->line = r.line;
+    }
+    else if (kind == XOMP_PROFILE_INSTANCE)
+    {
+      struct xomp_profile_instance instance;
+      uint32_t i;
+      if (fread(&instance, sizeof instance, 1, f) != 1)
+        truncated(argv[1]);
+      if (instance.nthreads > nallocated)
+      {
+        nallocated = instance.nthreads;
+        threads = (struct xomp_profile_thread*) realloc(threads, nallocated * sizeof(struct xomp_profile_thread));
+      }
+      if (instance.nthreads > 0 && (threads == NULL ||
+                                    fread(threads, sizeof(struct xomp_profile_thread), instance.nthreads, f) != instance.nthreads))
+        truncated(argv[1]);
+
+      struct region_summary *s = region(instance.id);
+      double wall = instance.end - instance.start;
+      double min_work = -1.0, max_work = 0.0;
+      s->count++;
+      s->total += wall;
+      for (i = 0; i < instance.nthreads; i++)
+      {
+        const struct xomp_profile_thread *t = &threads[i];
+        if (t->end <= 0.0)
+          continue;             // thread number not used in this instance
+        double work = t->end - t->begin - t->barrier;
+        if (min_work < 0.0 || work < min_work)
+          min_work = work;
+        if (work > max_work)
+          max_work = work;
+        s->thread_time += wall;
+        s->wait += t->barrier + (wall - t->end);
+        s->cycles += (double) t->cycles;
+        s->cache_misses += (double) t->cache_misses;
+      }
+      if (min_work > 0.0)
+      {
+        s->imbalance += max_work / min_work;
+        s->nbalanced++;
+      }
+    }
+    else
+      truncated(argv[1]);
+  }
+  fclose(f);
+  free(threads);
+
+  qsort(regions, nregions, sizeof(struct region_summary), by_total);
+  printf("%-40s %8s %12s %12s %7s %8s", "region", "count", "total(s)", "mean(s)", "imbal", "barrier");
+  if (header.flags & XOMP_PROFILE_HAS_COUNTERS)
+    printf(" %10s %8s", "Mcycles", "miss/Kc");
+  printf("\n");
+
+  size_t i;
+  for (i = 0; i < nregions; i++)
+  {
+    const struct region_summary *s = &regions[i];
+    char location[41];
+    if (s->count == 0)
+      continue;
+    const char *name = s->file_name != NULL ? s->file_name : "?";
+    size_t length = strlen(name);
+    // keep the end of long paths, which is the informative part
+    snprintf(location, sizeof location, "%s:%d", length > 32 ? name + length - 32 : name, s->line);
+    printf("%-40s %8lu %12.6f %12.6f %7.2f %7.1f%%", location, s->count, s->total, s->total / s->count,
+           s->nbalanced > 0 ? s->imbalance / s->nbalanced : 1.0,
+           s->thread_time > 0.0 ? 100.0 * s->wait / s->thread_time : 0.0);
+    if (header.flags & XOMP_PROFILE_HAS_COUNTERS)
+      printf(" %10.1f %8.2f", s->cycles / 1.0e6, s->cycles > 0.0 ? 1000.0 * s->cache_misses / s->cycles : 0.0);
+    printf("\n");
+  }
+  return 0;
+}
@@ -0,0 +1,222 @@
+// WARNING: Changes to this file must be contributed back to Sawyer or else they will
+//          be clobbered by the next update from Sawyer.  The Sawyer repository is at
+//          https://github.com/matzke1/sawyer.
+
+
+
+
+#ifndef Sawyer_FrozenGraph_H
+#define Sawyer_FrozenGraph_H
+
+#include <Sawyer/Assert.h>
+#include <Sawyer/Optional.h>                            // for Sawyer::Nothing
+#include <Sawyer/Sawyer.h>
+#include <boost/foreach.hpp>
+#include <boost/range/iterator_range.hpp>
+#include <vector>
+
+namespace Sawyer {
+namespace Container {
+
+/** Read-only graph with contiguous adjacency storage.
+ *
+ *  A @ref Graph stores its vertices and edges in linked lists, and each vertex has intrusive lists of incoming and outgoing
+ *  edges. That makes insertion and erasure cheap, but following edges touches memory all over the heap. A frozen graph is an
+ *  immutable snapshot of a graph in compressed sparse row (CSR) form: the out-edges of all vertices are stored in one array
+ *  sorted by source vertex and indexed by an array of per-vertex offsets, and likewise for the in-edges. Vertex and edge
+ *  values are stored in arrays indexed by ID. Algorithms over large read-mostly graphs such as finished control flow graphs
+ *  and call graphs are therefore much faster on a frozen graph; see the <code>frozenGraph*</code> functions in
+ *  GraphAlgorithm.h.
+ *
+ *  Vertices and edges are identified by the same ID numbers as in the graph from which the snapshot was made, and the edges
+ *  of each vertex are in the same order as in that graph, so algorithms visit them in the same order.
+ *
+ *  The @p V and @p E template arguments are the types of the vertex and edge values. They default to @ref Nothing for
+ *  snapshots that only need the connectivity, in which case the values of the source graph are not copied.
+ *
+ *  @code
+ *  typedef Sawyer::Container::Graph<std::string, double> MyGraph;
+ *  MyGraph graph = ...;
+ *  Sawyer::Container::FrozenGraph<> frozen(graph);        // connectivity only
+ *  std::vector<size_t> idoms = Sawyer::Container::Algorithm::frozenGraphDominators(frozen, 0);
+ *  @endcode */
+template<class V = Nothing, class E = Nothing>
+class FrozenGraph {
+public:
+    typedef V VertexValue;                              /**< User-level data associated with vertices. */
+    typedef E EdgeValue;                                /**< User-level data associated with edges. */
+
+    /** Iterator over vertex or edge ID numbers. */
+    typedef std::vector<size_t>::const_iterator IdIterator;
+
+    /** Range of vertex or edge ID numbers. */
+    typedef boost::iterator_range<IdIterator> IdRange;
+
+private:
+    std::vector<VertexValue> vertexValues_;             // indexed by vertex ID
+    std::vector<EdgeValue> edgeValues_;                 // indexed by edge ID
+    std::vector<size_t> sources_, targets_;             // endpoints indexed by edge ID
+
+    // Out-edges of vertex v are at [outOffsets_[v], outOffsets_[v+1]) of outEdges_ (edge IDs) and outVertices_ (their
+    // targets). Likewise for in-edges and their sources.
+    std::vector<size_t> outOffsets_, outEdges_, outVertices_;
+    std::vector<size_t> inOffsets_, inEdges_, inVertices_;
+
+public:
+    /** Construct an empty graph. */
+    FrozenGraph() {
+        outOffsets_.push_back(0);
+        inOffsets_.push_back(0);
+    }
+
+    /** Construct a snapshot of a graph.
+     *
+     *  The @p graph is usually a @ref Graph, but can be any type having the same vertex and edge interface. Vertex and edge
+     *  values are copied unless this frozen graph's value type is @ref Nothing.
+     *
+     *  Time complexity is O(|V|+|E|). */
+    template<class Graph>
+    explicit FrozenGraph(const Graph &graph) {
+        const size_t nv = graph.nVertices(), ne = graph.nEdges();
+
+        vertexValues_.reserve(nv);
+        for (size_t i=0; i<nv; ++i)
+            appendValue(vertexValues_, graph.findVertex(i)->value());
+
+        edgeValues_.reserve(ne);
+        sources_.resize(ne);
+        targets_.resize(ne);
+        for (size_t i=0; i<ne; ++i) {
+            typename Graph::ConstEdgeIterator edge = graph.findEdge(i);
+            appendValue(edgeValues_, edge->value());
+            sources_[i] = edge->source()->id();
+            targets_[i] = edge->target()->id();
+        }
+
+        outOffsets_.reserve(nv+1);
+        outEdges_.reserve(ne);
+        outVertices_.reserve(ne);
+        inOffsets_.reserve(nv+1);
+        inEdges_.reserve(ne);
+        inVertices_.reserve(ne);
+        for (size_t i=0; i<nv; ++i) {
+            typename Graph::ConstVertexIterator vertex = graph.findVertex(i);
+            outOffsets_.push_back(outEdges_.size());
+            BOOST_FOREACH (const typename Graph::Edge &edge, vertex->outEdges()) {
+                outEdges_.push_back(edge.id());
+                outVertices_.push_back(edge.target()->id());
+            }
+            inOffsets_.push_back(inEdges_.size());
+            BOOST_FOREACH (const typename Graph::Edge &edge, vertex->inEdges()) {
+                inEdges_.push_back(edge.id());
+                inVertices_.push_back(edge.source()->id());
+            }
+        }
+        outOffsets_.push_back(outEdges_.size());
+        inOffsets_.push_back(inEdges_.size());
+        ASSERT_require(outEdges_.size() == ne);
+        ASSERT_require(inEdges_.size() == ne);
+    }
+
+    /** Number of vertices. */
+    size_t nVertices() const {
+        return vertexValues_.size();
+    }
+
+    /** Number of edges. */
+    size_t nEdges() const {
+        return edgeValues_.size();
+    }
+
+    /** True if the graph has no vertices. */
+    bool isEmpty() const {
+        return vertexValues_.empty();
+    }
+
+    /** True if the vertex ID exists. */
+    bool isValidVertex(size_t vertexId) const {
+        return vertexId < nVertices();
+    }
+
+    /** Value of a vertex. */
+    const VertexValue& vertexValue(size_t vertexId) const {
+        ASSERT_require(isValidVertex(vertexId));
+        return vertexValues_[vertexId];
+    }
+
+    /** Value of an edge. */
+    const EdgeValue& edgeValue(size_t edgeId) const {
+        ASSERT_require(edgeId < nEdges());
+        return edgeValues_[edgeId];
+    }
+
+    /** Source vertex of an edge. */
+    size_t source(size_t edgeId) const {
+        ASSERT_require(edgeId < nEdges());
+        return sources_[edgeId];
+    }
+
+    /** Target vertex of an edge. */
+    size_t target(size_t edgeId) const {
+        ASSERT_require(edgeId < nEdges());
+        return targets_[edgeId];
+    }
+
+    /** Number of edges leaving a vertex. */
+    size_t nOutEdges(size_t vertexId) const {
+        ASSERT_require(isValidVertex(vertexId));
+        return outOffsets_[vertexId+1] - outOffsets_[vertexId];
+    }
+
+    /** Number of edges entering a vertex. */
+    size_t nInEdges(size_t vertexId) const {
+        ASSERT_require(isValidVertex(vertexId));
+        return inOffsets_[vertexId+1] - inOffsets_[vertexId];
+    }
+
+    /** IDs of the edges leaving a vertex. */
+    IdRange outEdges(size_t vertexId) const {
+        return range(outEdges_, outOffsets_, vertexId);
+    }
+
+    /** IDs of the edges entering a vertex. */
+    IdRange inEdges(size_t vertexId) const {
+        return range(inEdges_, inOffsets_, vertexId);
+    }
+
+    /** Targets of the edges leaving a vertex.
+     *
+     *  The range is parallel to @ref outEdges and has one element per edge, so a vertex appears more than once if there are
+     *  parallel edges. */
+    IdRange successors(size_t vertexId) const {
+        return range(outVertices_, outOffsets_, vertexId);
+    }
+
+    /** Sources of the edges entering a vertex.
+     *
+     *  The range is parallel to @ref inEdges and has one element per edge. */
+    IdRange predecessors(size_t vertexId) const {
+        return range(inVertices_, inOffsets_, vertexId);
+    }
+
+private:
+    IdRange range(const std::vector<size_t> &ids, const std::vector<size_t> &offsets, size_t vertexId) const {
+        ASSERT_require(isValidVertex(vertexId));
+        return IdRange(ids.begin() + offsets[vertexId], ids.begin() + offsets[vertexId+1]);
+    }
+
+    template<class T, class U>
+    static void appendValue(std::vector<T> &values, const U &value) {
+        values.push_back(value);
+    }
+
+    template<class U>
+    static void appendValue(std::vector<Nothing> &values, const U&) {
+        values.push_back(Nothing());
+    }
+};
+
+} // namespace
+} // namespace
+
+#endif
@@ -12,6 +12,7 @@
 
 #include <Sawyer/Sawyer.h>
 #include <Sawyer/DenseIntegerSet.h>
+#include <Sawyer/FrozenGraph.h>
 #include <Sawyer/GraphIteratorMap.h>
 #include <Sawyer/GraphTraversal.h>
 #include <Sawyer/Set.h>
@@ -1272,6 +1273,293 @@ graphPostDominators(Graph &g, typename GraphTraits<Graph>::VertexIterator root)
     return graphDirectedDominators<ReverseTraversalTag>(g, root);
 }
 
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+// Algorithms for frozen graphs
+////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+
+/** Neighbors of a frozen graph vertex in the direction of travel.
+ *
+ *  Returns the successors when following edges forward and the predecessors when following them in reverse.
+ *
+ * @{ */
+template<class V, class E>
+typename FrozenGraph<V, E>::IdRange
+frozenGraphNextVertices(const FrozenGraph<V, E> &g, size_t vertexId, ForwardTraversalTag) {
+    return g.successors(vertexId);
+}
+
+template<class V, class E>
+typename FrozenGraph<V, E>::IdRange
+frozenGraphNextVertices(const FrozenGraph<V, E> &g, size_t vertexId, ReverseTraversalTag) {
+    return g.predecessors(vertexId);
+}
+/** @} */
+
+/** Neighbors of a frozen graph vertex against the direction of travel.
+ *
+ *  Returns the predecessors when following edges forward and the successors when following them in reverse.
+ *
+ * @{ */
+template<class V, class E>
+typename FrozenGraph<V, E>::IdRange
+frozenGraphPreviousVertices(const FrozenGraph<V, E> &g, size_t vertexId, ForwardTraversalTag) {
+    return g.predecessors(vertexId);
+}
+
+template<class V, class E>
+typename FrozenGraph<V, E>::IdRange
+frozenGraphPreviousVertices(const FrozenGraph<V, E> &g, size_t vertexId, ReverseTraversalTag) {
+    return g.successors(vertexId);
+}
+/** @} */
+
+/** IDs of vertices reachable from a root in a frozen graph.
+ *
+ *  Returns the IDs of the vertices reachable from @p root by following edges in the specified direction, listed in the
+ *  order in which a depth-first traversal leaves them (post-order). The root is therefore last.  Unlike the traversals in
+ *  GraphTraversal.h, this uses an explicit stack and does not recurse.
+ *
+ *  Time complexity is O(|V|+|E|).
+ *
+ * @{ */
+template<class Direction, class V, class E>
+std::vector<size_t>
+frozenGraphDirectedReachableVertices(const FrozenGraph<V, E> &g, size_t root) {
+    typedef typename FrozenGraph<V, E>::IdIterator IdIterator;
+    ASSERT_require(g.isValidVertex(root));
+
+    std::vector<size_t> postorder;
+    std::vector<bool> seen(g.nVertices(), false);
+    std::vector<std::pair<size_t, IdIterator> > stack;
+    seen[root] = true;
+    stack.push_back(std::make_pair(root, frozenGraphNextVertices(g, root, Direction()).begin()));
+    while (!stack.empty()) {
+        size_t vertexId = stack.back().first;
+        if (stack.back().second != frozenGraphNextVertices(g, vertexId, Direction()).end()) {
+            size_t nextId = *stack.back().second;
+            ++stack.back().second;
+            if (!seen[nextId]) {
+                seen[nextId] = true;
+                stack.push_back(std::make_pair(nextId, frozenGraphNextVertices(g, nextId, Direction()).begin()));
+            }
+        } else {
+            postorder.push_back(vertexId);
+            stack.pop_back();
+        }
+    }
+    return postorder;
+}
+
+template<class V, class E>
+std::vector<size_t>
+frozenGraphReachableVertices(const FrozenGraph<V, E> &g, size_t root) {
+    return frozenGraphDirectedReachableVertices<ForwardTraversalTag>(g, root);
+}
+/** @} */
+
+/** Find immediate pre- or post-dominators in a frozen graph.
+ *
+ *  This is the same algorithm as @ref graphDirectedDominators but operates on vertex IDs. The returned vector is indexed by
+ *  vertex ID and contains the ID of the vertex's immediate dominator, or <code>(size_t)(-1)</code> if the vertex has no
+ *  dominator (the root, and vertices not reachable from the root). */
+template<class Direction, class V, class E>
+std::vector<size_t>
+frozenGraphDirectedDominators(const FrozenGraph<V, E> &g, size_t root) {
+    typedef typename FrozenGraph<V, E>::IdRange IdRange;
+    static const size_t NO_ID = (size_t)(-1);
+
+    // Vertex IDs in reverse post-order, and the inverse mapping. See graphDirectedDominators.
+    std::vector<size_t> flowlist = frozenGraphDirectedReachableVertices<Direction>(g, root);
+    std::reverse(flowlist.begin(), flowlist.end());
+    std::vector<size_t> rflowlist(g.nVertices(), NO_ID);
+    for (size_t i=0; i<flowlist.size(); ++i)
+        rflowlist[flowlist[i]] = i;
+
+    // idom[i]==i implies idom[i] is unknown
+    std::vector<size_t> idom(flowlist.size());
+    for (size_t i=0; i<flowlist.size(); ++i)
+        idom[i] = i;
+
+    bool changed = true;
+    while (changed) {
+        changed = false;
+        for (size_t vertex_i=1; vertex_i < flowlist.size(); ++vertex_i) { // flowlist[0] is the root
+            size_t newIdom = idom[vertex_i];
+            IdRange predecessors = frozenGraphPreviousVertices(g, flowlist[vertex_i], Direction());
+            BOOST_FOREACH (size_t predecessorId, predecessors) {
+                size_t predecessor_i = rflowlist[predecessorId];
+                if (NO_ID == predecessor_i || predecessor_i >= vertex_i)
+                    continue;                           // unreachable predecessor, self edge, or back edge
+
+                if (newIdom == vertex_i) {
+                    newIdom = predecessor_i;
+                } else {
+                    size_t tmpIdom = predecessor_i;
+                    while (newIdom != tmpIdom) {
+                        while (newIdom > tmpIdom)
+                            newIdom = idom[newIdom];
+                        while (tmpIdom > newIdom)
+                            tmpIdom = idom[tmpIdom];
+                    }
+                }
+            }
+
+            if (idom[vertex_i] != newIdom) {
+                idom[vertex_i] = newIdom;
+                changed = true;
+            }
+        }
+    }
+
+    std::vector<size_t> retval(g.nVertices(), NO_ID);
+    for (size_t i=0; i<flowlist.size(); ++i) {
+        if (idom[i] != i)
+            retval[flowlist[i]] = flowlist[idom[i]];
+    }
+    return retval;
+}
+
+/** Find immediate pre-dominators in a frozen graph.
+ *
+ *  See @ref frozenGraphDirectedDominators. */
+template<class V, class E>
+std::vector<size_t>
+frozenGraphDominators(const FrozenGraph<V, E> &g, size_t root) {
+    return frozenGraphDirectedDominators<ForwardTraversalTag>(g, root);
+}
+
+/** Find immediate post-dominators in a frozen graph.
+ *
+ *  See @ref frozenGraphDirectedDominators. */
+template<class V, class E>
+std::vector<size_t>
+frozenGraphPostDominators(const FrozenGraph<V, E> &g, size_t root) {
+    return frozenGraphDirectedDominators<ReverseTraversalTag>(g, root);
+}
+
+/** Find the strongly connected components of a frozen graph.
+ *
+ *  Numbers the strongly connected components starting at zero and initializes the provided vector to map each vertex ID to
+ *  its component number. Returns the number of components. This is Tarjan's algorithm with an explicit stack, so components
+ *  are numbered in reverse topological order: no edge leads from a component to a component with a higher number.
+ *
+ *  Time complexity is O(|V|+|E|). */
+template<class V, class E>
+size_t
+frozenGraphStronglyConnectedComponents(const FrozenGraph<V, E> &g, std::vector<size_t> &components /*out*/) {
+    typedef typename FrozenGraph<V, E>::IdIterator IdIterator;
+    static const size_t NO_ID = (size_t)(-1);
+    const size_t nv = g.nVertices();
+
+    components.clear();
+    components.resize(nv, NO_ID);
+    std::vector<size_t> index(nv, NO_ID), lowlink(nv, 0);
+    std::vector<size_t> sccStack;                       // vertices not yet assigned to a component
+    std::vector<std::pair<size_t, IdIterator> > callStack;
+    size_t nextIndex = 0, nComponents = 0;
+
+    for (size_t rootId = 0; rootId < nv; ++rootId) {
+        if (index[rootId] != NO_ID)
+            continue;
+        index[rootId] = lowlink[rootId] = nextIndex++;
+        sccStack.push_back(rootId);
+        callStack.push_back(std::make_pair(rootId, g.successors(rootId).begin()));
+
+        while (!callStack.empty()) {
+            size_t vertexId = callStack.back().first;
+            if (callStack.back().second != g.successors(vertexId).end()) {
+                size_t nextId = *callStack.back().second;
+                ++callStack.back().second;
+                if (index[nextId] == NO_ID) {
+                    index[nextId] = lowlink[nextId] = nextIndex++;
+                    sccStack.push_back(nextId);
+                    callStack.push_back(std::make_pair(nextId, g.successors(nextId).begin()));
+                } else if (components[nextId] == NO_ID) { // on the SCC stack
+                    lowlink[vertexId] = std::min(lowlink[vertexId], index[nextId]);
+                }
+            } else {
+                callStack.pop_back();
+                if (lowlink[vertexId] == index[vertexId]) {
+                    size_t memberId;
+                    do {
+                        memberId = sccStack.back();
+                        sccStack.pop_back();
+                        components[memberId] = nComponents;
+                    } while (memberId != vertexId);
+                    ++nComponents;
+                }
+                if (!callStack.empty()) {
+                    size_t parentId = callStack.back().first;
+                    lowlink[parentId] = std::min(lowlink[parentId], lowlink[vertexId]);
+                }
+            }
+        }
+    }
+    return nComponents;
+}
+
+/** Enumerate the paths between two vertices of a frozen graph.
+ *
+ *  Calls @p visitor once for each path from @p source to @p target that visits no vertex more than once. The path is passed
+ *  as a <code>const std::vector<size_t>&</code> of edge IDs in order from the source, and the visitor returns true to continue
+ *  the enumeration or false to stop it. If the source and target are the same vertex, the only such path is the empty path.
+ *  Returns the number of paths passed to the visitor.
+ *
+ *  The number of paths can be exponential in the size of the graph. Vertices from which the target cannot be reached are
+ *  pruned before the search starts. */
+template<class V, class E, class Visitor>
+size_t
+frozenGraphFindPaths(const FrozenGraph<V, E> &g, size_t source, size_t target, Visitor visitor) {
+    typedef typename FrozenGraph<V, E>::IdIterator IdIterator;
+    ASSERT_require(g.isValidVertex(source));
+    ASSERT_require(g.isValidVertex(target));
+
+    std::vector<size_t> path;
+    if (source == target) {
+        visitor(static_cast<const std::vector<size_t>&>(path));
+        return 1;
+    }
+
+    std::vector<bool> reachesTarget(g.nVertices(), false);
+    BOOST_FOREACH (size_t vertexId, frozenGraphDirectedReachableVertices<ReverseTraversalTag>(g, target))
+        reachesTarget[vertexId] = true;
+    if (!reachesTarget[source])
+        return 0;
+
+    size_t nPaths = 0;
+    std::vector<bool> onPath(g.nVertices(), false);
+    std::vector<std::pair<size_t, IdIterator> > stack;  // vertex and its next out-edge
+    onPath[source] = true;
+    stack.push_back(std::make_pair(source, g.outEdges(source).begin()));
+    while (!stack.empty()) {
+        size_t vertexId = stack.back().first;
+        if (stack.back().second == g.outEdges(vertexId).end()) {
+            onPath[vertexId] = false;
+            stack.pop_back();
+            if (!path.empty())
+                path.pop_back();
+            continue;
+        }
+
+        size_t edgeId = *stack.back().second;
+        ++stack.back().second;
+        size_t nextId = g.target(edgeId);
+        if (nextId == target) {
+            path.push_back(edgeId);
+            ++nPaths;
+            bool proceed = visitor(static_cast<const std::vector<size_t>&>(path));
+            path.pop_back();
+            if (!proceed)
+                break;
+        } else if (!onPath[nextId] && reachesTarget[nextId]) {
+            path.push_back(edgeId);
+            onPath[nextId] = true;
+            stack.push_back(std::make_pair(nextId, g.outEdges(nextId).begin()));
+        }
+    }
+    return nPaths;
+}
+
 } // namespace
 } // namespace
 } // namespace
@@ -12,6 +12,7 @@
 #include <boost/foreach.hpp>
 #include <boost/static_assert.hpp>
 #include <boost/cstdint.hpp>
+#include <boost/type_traits/is_same.hpp>
 #include <list>
 #include <Sawyer/Assert.h>
 #include <Sawyer/Interval.h>
@@ -20,6 +21,16 @@
 #include <Sawyer/Synchronization.h>
 #include <vector>
 
+// Per-thread caches need atomic operations and thread-local storage whose destructors run when a thread exits (so that the
+// cells cached by the thread can be given back to the pool), both of which first appeared in C++11.
+#if SAWYER_MULTI_THREADED && __cplusplus >= 201103L
+    #define SAWYER_POOL_ALLOCATOR_THREAD_CACHES 1
+    #include <atomic>
+    #include <memory>
+#else
+    #define SAWYER_POOL_ALLOCATOR_THREAD_CACHES 0
+#endif
+
 namespace Sawyer {
 
 /** Small object allocation from memory pools.
@@ -48,6 +59,15 @@ namespace Sawyer {
  *
  *  The @ref SynchronizedPoolAllocator and @ref UnsynchronizedPoolAllocator typedefs provide reasonable template arguments.
  *
+ *  Free cells are handed around in magazines of up to @ref MAGAZINE_SIZE cells. In a multi-threaded allocator (when compiled
+ *  with thread support and C++11 or later), each thread has its own two magazines per pool and allocates from and deallocates
+ *  to them without any synchronization. Only when both are empty (or both are full) does the thread exchange a whole
+ *  magazine with the pool's depot, which is a small array of slots that are accessed with lock-free atomic operations.
+ *  Magazines that don't fit in the depot, and magazines cut from new chunks, go through a list protected by the pool's
+ *  mutex.  When a thread exits, its magazines are given back to the pool the next time a thread is added or the allocator is
+ *  vacuumed. Otherwise (single-threaded allocators, or no C++11) each pool has one set of magazines protected by the pool's
+ *  mutex.
+ *
  *  When a pool allocator is copied, only its settings are copied, not the pools.  Since containers typically copy their
  *  constructor-provided allocators, each container will have its own pools even if one provides the same pool to all the
  *  constructors.  See @ref ProxyAllocator for a way to avoid this, and to allow different containers to share the same
@@ -63,13 +83,52 @@ public:
     enum { SIZE_DELTA = sizeDelta };
     enum { N_POOLS = nPools };
     enum { CHUNK_SIZE = chunkSize };
-    enum { N_FREE_LISTS = 32 };                          // number of free lists per pool
+    enum { N_FREE_LISTS = 32 };                         // number of lock-free depot slots per pool
+    enum { MAGAZINE_SIZE = 32 };                        // maximum number of cells per magazine
+
+    /** Allocation statistics for one pool.
+     *
+     *  The counts are sums over all threads and are only approximate while other threads are using the allocator. */
+    struct PoolStatistics {
+        size_t cellSize;                                /**< Size of each cell in bytes. */
+        size_t nChunks;                                 /**< Number of chunks allocated from the system. */
+        size_t nAllocations;                            /**< Number of objects allocated from this pool. */
+        size_t nDeallocations;                          /**< Number of objects deallocated to this pool. */
+        size_t nMisses;                                 /**< Allocations that had to get a magazine from the pool. */
+
+        PoolStatistics()
+            : cellSize(0), nChunks(0), nAllocations(0), nDeallocations(0), nMisses(0) {}
+
+        /** Bytes of memory obtained from the system for this pool. */
+        size_t nBytesReserved() const {
+            return nChunks * chunkSize;
+        }
+
+        /** Number of objects currently allocated. */
+        size_t nObjectsInUse() const {
+            return nAllocations > nDeallocations ? nAllocations - nDeallocations : 0;
+        }
+
+        /** Bytes of memory currently used by allocated objects. */
+        size_t nBytesInUse() const {
+            return nObjectsInUse() * cellSize;
+        }
+
+        /** Fraction of allocations satisfied by the calling thread's magazines. */
+        double hitRate() const {
+            return nAllocations > 0 ? 1.0 - (double)nMisses / nAllocations : 1.0;
+        }
+    };
 
 private:
 
     // Singly-linked list of cells (units of object backing store) that are not being used by the caller.
     struct FreeCell { FreeCell *next; };
 
+    // Pools are protected by null mutexes in single-threaded allocators.
+    typedef typename SynchronizationTraits<Sync>::Mutex PoolMutex;
+    typedef typename SynchronizationTraits<Sync>::LockGuard PoolLockGuard;
+
     typedef Sawyer::Container::Interval<boost::uint64_t> ChunkAddressInterval;
 
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -116,55 +175,130 @@ private:
 
     typedef Sawyer::Container::IntervalMap<ChunkAddressInterval, ChunkInfo> ChunkInfoMap;
 
-    class Pool;
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+    //                                  Magazines and per-thread caches
+    ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
+private:
+    // A list of free cells and its length.
+    struct Magazine {
+        FreeCell *head;
+        size_t n;
+
+        Magazine(): head(NULL), n(0) {}
+        Magazine(FreeCell *head, size_t n): head(head), n(n) {}
+
+        void push(FreeCell *cell) {
+            cell->next = head;
+            head = cell;
+            ++n;
+        }
 
-    // Aquire all locks for a pool.
-    class LockEverything {
-        SAWYER_THREAD_TRAITS::Mutex *freeListMutexes_, &chunkMutex_;
-        size_t nLocked_;
-    public:
-        LockEverything(SAWYER_THREAD_TRAITS::Mutex *freeListMutexes, SAWYER_THREAD_TRAITS::Mutex &chunkMutex)
-            : freeListMutexes_(freeListMutexes), chunkMutex_(chunkMutex), nLocked_(0) {
-            while (nLocked_ < N_FREE_LISTS) {
-                freeListMutexes_[nLocked_].lock();
-                ++nLocked_;
-            }
-            chunkMutex_.lock();
+        FreeCell* pop() {
+            ASSERT_not_null(head);
+            FreeCell *cell = head;
+            head = cell->next;
+            --n;
+            return cell;
         }
+    };
 
-        ~LockEverything() {
-            while (nLocked_ > 0) {
-                freeListMutexes_[nLocked_-1].unlock();
-                --nLocked_;
-            }
-            chunkMutex_.unlock();
+    // Event counter that is incremented only by the thread that owns it, but may be read by any thread.
+    class Counter {
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        std::atomic<size_t> n_;
+    public:
+        Counter(): n_(0) {}
+        void add(size_t n) { n_.store(n_.load(std::memory_order_relaxed) + n, std::memory_order_relaxed); }
+        size_t get() const { return n_.load(std::memory_order_relaxed); }
+#else
+        size_t n_;
+    public:
+        Counter(): n_(0) {}
+        void add(size_t n) { n_ += n; }
+        size_t get() const { return n_; }
+#endif
+    };
+
+    // The magazines used by one thread for one pool. The previous magazine is always either empty or full so that a thread
+    // can switch between allocating and deallocating at least MAGAZINE_SIZE times without touching the pool.
+    struct PoolCache {
+        Magazine loaded;
+        Magazine previous;
+        Counter nAllocations;
+        Counter nDeallocations;
+        Counter nMisses;
+    };
+
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+    // Single-threaded allocators don't need per-thread caches since the caller serializes all calls anyway.
+    static const bool USE_THREAD_CACHES = boost::is_same<Sync, MultiThreadedTag>::value;
+
+    // Magazines of one thread for all the pools of one allocator. The alive flag is shared with the thread's exit notifier.
+    struct ThreadCache {
+        PoolCache pools[nPools];
+        std::shared_ptr<std::atomic<bool> > alive;
+    };
+
+    // Thread-local table mapping allocator serial numbers to that thread's caches. Serial numbers are never reused, so
+    // entries for destroyed allocators are never matched.
+    struct TlsEntry {
+        boost::uint64_t serialNumber;
+        ThreadCache *cache;
+    };
+
+    enum { N_TLS_ENTRIES = 8 };
+
+    // Clears the thread's alive flag and its table of caches when the thread exits.
+    struct ThreadExitNotifier {
+        std::shared_ptr<std::atomic<bool> > alive;
+
+        ThreadExitNotifier()
+            : alive(std::make_shared<std::atomic<bool> >(true)) {}
+
+        ~ThreadExitNotifier() {
+            threadExiting_ = true;
+            for (size_t i = 0; i < N_TLS_ENTRIES; ++i)
+                tlsCaches_[i] = TlsEntry();
+            alive->store(false, std::memory_order_release);
         }
     };
 
+    static thread_local TlsEntry tlsCaches_[N_TLS_ENTRIES];
+    static thread_local bool threadExiting_;
+    static thread_local ThreadExitNotifier threadExitNotifier_;
+    static std::atomic<boost::uint64_t> nextSerialNumber_;
+#endif
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //                                  Pool of single-sized cells; collection of chunks
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     class Pool {
         size_t cellSize_;                               // only modified immediately after construction
 
-        // Multiple free-lists for parallelism reduces the contention on the pool. The aquire and release methods select a
-        // free-list uniformly at random in order to keep the sizes of the free-lists relatively equal. There is no requirement
-        // that an object allocated from one free-list be released back to the same free-list. Each free-list has its own
-        // mutex. When locking multiple free-lists, the locks should be aquired in order of their indexes.
-        SAWYER_THREAD_TRAITS::Mutex freeListMutexes_[N_FREE_LISTS];
-        FreeCell *freeLists_[N_FREE_LISTS];
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        // Depot of full magazines. A slot is either empty or holds one full magazine. Threads take a magazine by exchanging
+        // the slot with null and give one back by a compare-and-swap from null, so no slot is ever compared against a
+        // pointer that might have been recycled in the meantime (no ABA problem).
+        std::atomic<FreeCell*> depot_[N_FREE_LISTS];
+#endif
 
-        // The chunk-list stores the memory allocated for objects.  The chunk-list is protected by a mutex. When locking
-        // free-list(s) and the chunk-list, the free-list locks should be aquired first.
-        mutable SAWYER_THREAD_TRAITS::Mutex chunkMutex_;
+        // Everything below is protected by the mutex. This includes the chunk-list, which stores the memory allocated for
+        // objects, the magazines that didn't fit in the depot (which need not be full), and the magazines used by threads
+        // that have no cache of their own.
+        mutable PoolMutex mutex_;
         std::list<Chunk*> chunks_;
+        std::vector<Magazine> overflow_;
+        PoolCache sharedCache_;
 
     private:
         Pool(const Pool&);                              // nonsense
 
     public:
         Pool(): cellSize_(0) {
-            memset(freeLists_, 0, sizeof freeLists_);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            for (size_t i = 0; i < N_FREE_LISTS; ++i)
+                depot_[i].store(NULL, std::memory_order_relaxed);
+#endif
         }
 
         void init(size_t cellSize) {
@@ -180,117 +314,151 @@ private:
         }
 
         bool isEmpty() const {
-            SAWYER_THREAD_TRAITS::LockGuard lock(chunkMutex_);
+            PoolLockGuard lock(mutex_);
             return chunks_.empty();
         }
 
-        // Obtains the cell at the front of the free list, allocating more space if necessary.
-        void* aquire() {                                // hot
-            const size_t freeListIdx = fastRandomIndex(N_FREE_LISTS);
-            SAWYER_THREAD_TRAITS::LockGuard lock(freeListMutexes_[freeListIdx]);
-            if (!freeLists_[freeListIdx]) {
-                Chunk *chunk = new Chunk;
-                freeLists_[freeListIdx] = chunk->fill(cellSize_);
-                SAWYER_THREAD_TRAITS::LockGuard lock(chunkMutex_);
-                chunks_.push_back(chunk);
+        // Obtains a cell from the calling thread's magazines, refilling them from the pool if necessary. If haveLock is
+        // set then the caller holds the pool's mutex.
+        void* aquire(PoolCache &cache, bool haveLock) { // hot
+            cache.nAllocations.add(1);
+            if (0 == cache.loaded.n) {
+                if (cache.previous.n > 0) {
+                    std::swap(cache.loaded, cache.previous);
+                } else {
+                    cache.nMisses.add(1);
+                    cache.loaded = haveLock ? takeMagazineNS() : takeMagazine();
+                }
             }
-            ASSERT_not_null(freeLists_[freeListIdx]);
-            FreeCell *cell = freeLists_[freeListIdx];
-            freeLists_[freeListIdx] = freeLists_[freeListIdx]->next;
+            FreeCell *cell = cache.loaded.pop();
             cell->next = NULL;                          // optional
             return cell;
         }
 
-        // Returns an cell to the front of the free list.
-        void release(void *cell) {                      // hot
-            const size_t freeListIdx = fastRandomIndex(N_FREE_LISTS);
-            SAWYER_THREAD_TRAITS::LockGuard lock(freeListMutexes_[freeListIdx]);
+        // Returns a cell to the calling thread's magazines, giving a full magazine back to the pool if necessary. If haveLock
+        // is set then the caller holds the pool's mutex.
+        void release(PoolCache &cache, void *cell, bool haveLock) { // hot
             ASSERT_not_null(cell);
-            FreeCell *freedCell = reinterpret_cast<FreeCell*>(cell);
-            freedCell->next = freeLists_[freeListIdx];
-            freeLists_[freeListIdx] = freedCell;
-        }
-
-        // Information about each chunk.
-        ChunkInfoMap chunkInfoNS() const {
-            ChunkInfoMap map;
-            BOOST_FOREACH (const Chunk* chunk, chunks_)
-                map.insert(chunk->extent(), ChunkInfo(chunk, chunkSize / cellSize_));
-            for (size_t freeListIdx = 0; freeListIdx < N_FREE_LISTS; ++freeListIdx) {
-                for (FreeCell *cell=freeLists_[freeListIdx]; cell!=NULL; cell=cell->next) {
-                    typename ChunkInfoMap::ValueIterator found = map.find(reinterpret_cast<boost::uint64_t>(cell));
-                    ASSERT_require2(found!=map.values().end(), "each freelist item must be some chunk cell");
-                    ASSERT_require2(found->nUsed > 0, "freelist must be consistent with chunk capacities");
-                    --found->nUsed;
+            cache.nDeallocations.add(1);
+            if (MAGAZINE_SIZE == cache.loaded.n) {
+                if (cache.previous.n > 0) {
+                    if (haveLock) {
+                        giveMagazineNS(cache.previous);
+                    } else {
+                        giveMagazine(cache.previous);
+                    }
                 }
+                cache.previous = cache.loaded;
+                cache.loaded = Magazine();
             }
-            return map;
+            cache.loaded.push(reinterpret_cast<FreeCell*>(cell));
+        }
+
+        // Allocate and deallocate using the pool's shared magazines.
+        void* aquireShared() {
+            PoolLockGuard lock(mutex_);
+            return aquire(sharedCache_, true);
+        }
+
+        void releaseShared(void *cell) {
+            PoolLockGuard lock(mutex_);
+            release(sharedCache_, cell, true);
+        }
+
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        // Give the magazines and counts of a thread that no longer uses them to the pool.
+        void retire(PoolCache &cache) {
+            PoolLockGuard lock(mutex_);
+            if (cache.loaded.n > 0)
+                overflow_.push_back(cache.loaded);
+            if (cache.previous.n > 0)
+                overflow_.push_back(cache.previous);
+            cache.loaded = cache.previous = Magazine();
+            sharedCache_.nAllocations.add(cache.nAllocations.get());
+            sharedCache_.nDeallocations.add(cache.nDeallocations.get());
+            sharedCache_.nMisses.add(cache.nMisses.get());
+        }
+#endif
+
+        // Statistics, not including those of threads' own caches.
+        PoolStatistics statistics() const {
+            PoolLockGuard lock(mutex_);
+            PoolStatistics stats;
+            stats.cellSize = cellSize_;
+            stats.nChunks = chunks_.size();
+            stats.nAllocations = sharedCache_.nAllocations.get();
+            stats.nDeallocations = sharedCache_.nDeallocations.get();
+            stats.nMisses = sharedCache_.nMisses.get();
+            return stats;
         }
 
         // Reserve objects to satisfy future allocation requests.
         void reserve(size_t nObjects) {
-            LockEverything guard(freeListMutexes_, chunkMutex_);
-            size_t nFree = 0;
-            for (size_t freeListIdx = 0; freeListIdx < N_FREE_LISTS; ++freeListIdx) {
-                for (FreeCell *cell = freeLists_[freeListIdx]; cell != NULL; cell = cell->next) {
-                    ++nFree;
-                    if (nFree >= nObjects)
-                        return;
-                }
+            PoolLockGuard lock(mutex_);
+            size_t nFree = sharedCache_.loaded.n + sharedCache_.previous.n;
+            BOOST_FOREACH (const Magazine &magazine, overflow_)
+                nFree += magazine.n;
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            for (size_t i = 0; i < N_FREE_LISTS; ++i) {
+                if (depot_[i].load(std::memory_order_relaxed) != NULL)
+                    nFree += MAGAZINE_SIZE;
             }
-
-            size_t freeListIdx = fastRandomIndex(N_FREE_LISTS);
-            size_t nNeeded = nObjects - nFree;
+#endif
             const size_t cellsPerChunk = chunkSize / cellSize_;
-            while (1) {
-                // Allocate a new chunk of object cells
-                Chunk *chunk = new Chunk;
-                FreeCell *newCells = chunk->fill(cellSize_);
-                chunks_.push_back(chunk);
-
-                // Insert the new object cells into the free lists in round-robin order
-                while (newCells) {
-                    FreeCell *cell = newCells;
-                    newCells = cell->next;
-                    cell->next = freeLists_[freeListIdx];
-                    freeLists_[freeListIdx] = cell;
-                    if (++freeListIdx >= N_FREE_LISTS)
-                        freeListIdx = 0;
-                }
-
-                if (nNeeded < cellsPerChunk)
-                    return;
+            while (nFree < nObjects) {
+                std::vector<Magazine> magazines = newChunkNS();
+                overflow_.insert(overflow_.end(), magazines.begin(), magazines.end());
+                nFree += cellsPerChunk;
             }
         }
-        
-        // Free unused chunks
+
+        // Free unused chunks. Cells in the threads' own magazines are considered to be in use.
         void vacuum() {
-            // We must aquire all the free list-locks plus the chunks-lock before we call chunkInfoNS. Free-list locks must be
-            // aquired before the chunk-list lock.
-            LockEverything guard(freeListMutexes_, chunkMutex_);
-            ChunkInfoMap map = chunkInfoNS();
-
-            // Scan the free lists, creating new free lists in the process.  For any cell on an old free list, if the cell
-            // belongs to a chunk that we're keeping, then copy the cell to a new free list.  The cells are copied round-robin
-            // to the new free lists so that the lists stay balanced.
-            FreeCell *newFreeLists[N_FREE_LISTS];
-            memset(newFreeLists, 0, sizeof newFreeLists);
-            size_t newFreeListIdx = 0;
-            for (size_t oldFreeListIdx=0; oldFreeListIdx<N_FREE_LISTS; ++oldFreeListIdx) {
+            PoolLockGuard lock(mutex_);
+
+            // Collect all the free cells that the pool knows about. A thread may give a magazine to the depot while we're
+            // doing this, in which case its cells are not seen and their chunk is conservatively kept.
+            std::vector<Magazine> free;
+            free.swap(overflow_);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            for (size_t i = 0; i < N_FREE_LISTS; ++i) {
+                if (FreeCell *cells = depot_[i].exchange(NULL, std::memory_order_acquire))
+                    free.push_back(Magazine(cells, MAGAZINE_SIZE));
+            }
+#endif
+            free.push_back(sharedCache_.loaded);
+            free.push_back(sharedCache_.previous);
+            sharedCache_.loaded = sharedCache_.previous = Magazine();
+
+            ChunkInfoMap map;
+            BOOST_FOREACH (const Chunk* chunk, chunks_)
+                map.insert(chunk->extent(), ChunkInfo(chunk, chunkSize / cellSize_));
+            BOOST_FOREACH (const Magazine &magazine, free) {
+                for (FreeCell *cell = magazine.head; cell != NULL; cell = cell->next) {
+                    typename ChunkInfoMap::ValueIterator found = map.find(reinterpret_cast<boost::uint64_t>(cell));
+                    ASSERT_require2(found!=map.values().end(), "each free cell must be some chunk cell");
+                    ASSERT_require2(found->nUsed > 0, "free cells must be consistent with chunk capacities");
+                    --found->nUsed;
+                }
+            }
+
+            // Keep the free cells of chunks that are still in use, in magazines of at most MAGAZINE_SIZE cells.
+            Magazine magazine;
+            BOOST_FOREACH (const Magazine &oldMagazine, free) {
                 FreeCell *next = NULL;
-                for (FreeCell *cell = freeLists_[oldFreeListIdx]; cell != NULL; cell = next) {
+                for (FreeCell *cell = oldMagazine.head; cell != NULL; cell = next) {
                     next = cell->next;
-                    boost::uint64_t cellAddr = reinterpret_cast<boost::uint64_t>(cell);
-                    if (map[cellAddr].nUsed != 0) {
-                        // Keep this cell by round-robin inserting it into a new free list.
-                        cell->next = newFreeLists[newFreeListIdx];
-                        newFreeLists[newFreeListIdx] = cell;
-                        if (++newFreeListIdx >= N_FREE_LISTS)
-                            newFreeListIdx = 0;
+                    if (map[reinterpret_cast<boost::uint64_t>(cell)].nUsed != 0) {
+                        magazine.push(cell);
+                        if (MAGAZINE_SIZE == magazine.n) {
+                            overflow_.push_back(magazine);
+                            magazine = Magazine();
+                        }
                     }
                 }
             }
-            memcpy(freeLists_, newFreeLists, sizeof newFreeLists);
+            if (magazine.n > 0)
+                overflow_.push_back(magazine);
 
             // Delete chunks that have no used cells.
             typename std::list<Chunk*>::iterator iter = chunks_.begin();
@@ -306,35 +474,75 @@ private:
             }
         }
 
-        size_t showInfo(std::ostream &out) const {
-            ChunkInfoMap cim;
-            {
-                LockEverything guard(const_cast<SAWYER_THREAD_TRAITS::Mutex*>(freeListMutexes_), chunkMutex_);
-                cim = chunkInfoNS();
+    private:
+        // Obtain a magazine with at least one cell.
+        Magazine takeMagazine() {
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            const size_t start = fastRandomIndex(N_FREE_LISTS);
+            for (size_t i = 0; i < N_FREE_LISTS; ++i) {
+                std::atomic<FreeCell*> &slot = depot_[(start + i) % N_FREE_LISTS];
+                if (slot.load(std::memory_order_relaxed) != NULL) {
+                    if (FreeCell *cells = slot.exchange(NULL, std::memory_order_acquire))
+                        return Magazine(cells, MAGAZINE_SIZE);
+                }
             }
+#endif
+            PoolLockGuard lock(mutex_);
+            return takeMagazineNS();
+        }
 
-            const size_t nCells = chunkSize / cellSize_;
-            size_t totalUsed=0;
-            BOOST_FOREACH (const ChunkInfo &info, cim.values()) {
-                out <<"  chunk " <<info.chunk <<"\t" <<info.nUsed <<"/" <<nCells <<"\t= " <<100.0*info.nUsed/nCells <<"%\n";
-                totalUsed += info.nUsed;
+        Magazine takeMagazineNS() {
+            if (overflow_.empty()) {
+                std::vector<Magazine> magazines = newChunkNS();
+                overflow_.insert(overflow_.end(), magazines.begin(), magazines.end());
             }
-            return totalUsed;
+            Magazine magazine = overflow_.back();
+            overflow_.pop_back();
+            ASSERT_require(magazine.n > 0);
+            return magazine;
         }
 
-        std::pair<size_t, size_t> nAllocated() const {
-            ChunkInfoMap cim;
-            {
-                LockEverything guard(const_cast<SAWYER_THREAD_TRAITS::Mutex*>(freeListMutexes_), chunkMutex_);
-                cim = chunkInfoNS();
+        // Give a full magazine back to the pool.
+        void giveMagazine(const Magazine &magazine) {
+            ASSERT_require(MAGAZINE_SIZE == magazine.n);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            const size_t start = fastRandomIndex(N_FREE_LISTS);
+            for (size_t i = 0; i < N_FREE_LISTS; ++i) {
+                std::atomic<FreeCell*> &slot = depot_[(start + i) % N_FREE_LISTS];
+                FreeCell *expected = NULL;
+                if (slot.load(std::memory_order_relaxed) == NULL &&
+                    slot.compare_exchange_strong(expected, magazine.head, std::memory_order_release))
+                    return;
             }
+#endif
+            PoolLockGuard lock(mutex_);
+            giveMagazineNS(magazine);
+        }
+
+        void giveMagazineNS(const Magazine &magazine) {
+            overflow_.push_back(magazine);
+        }
 
-            const size_t nCells = chunkSize / cellSize_;
-            size_t nReserved = nCells * cim.nIntervals();
-            size_t nAllocated = 0;
-            BOOST_FOREACH (const ChunkInfo &info, cim.values())
-                nAllocated += info.nUsed;
-            return std::make_pair(nAllocated, nReserved);
+        // Allocate a new chunk and cut it into magazines. The last magazine returned is full unless the chunk has fewer
+        // than MAGAZINE_SIZE cells.
+        std::vector<Magazine> newChunkNS() {
+            Chunk *chunk = new Chunk;
+            chunks_.push_back(chunk);
+
+            std::vector<Magazine> magazines;
+            Magazine magazine;
+            FreeCell *next = NULL;
+            for (FreeCell *cell = chunk->fill(cellSize_); cell != NULL; cell = next) {
+                next = cell->next;
+                magazine.push(cell);
+                if (MAGAZINE_SIZE == magazine.n) {
+                    magazines.push_back(magazine);
+                    magazine = Magazine();
+                }
+            }
+            if (magazine.n > 0)
+                magazines.insert(magazines.begin(), magazine);
+            return magazines;
         }
     };
 
@@ -344,13 +552,72 @@ private:
 private:
     Pool *pools_;                                       // modified only in constructors and destructor
 
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+    boost::uint64_t serialNumber_;                      // unique among all allocators of this type; never zero
+    mutable SAWYER_THREAD_TRAITS::Mutex cachesMutex_;   // protects caches_; aquire before any pool mutex
+    std::vector<ThreadCache*> caches_;                  // caches of all threads that used this allocator
+#endif
+
     // Called only by constructors
     void init() {
         pools_ = new Pool[nPools];
         for (size_t i=0; i<nPools; ++i)
             pools_[i].init(cellSize(i));
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        serialNumber_ = ++nextSerialNumber_;
+#endif
     }
 
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+    // The calling thread's cache for this allocator, or null if the thread is exiting.
+    ThreadCache* threadCache() {                        // hot
+        TlsEntry &entry = tlsCaches_[serialNumber_ % N_TLS_ENTRIES];
+        if (entry.serialNumber == serialNumber_)
+            return entry.cache;
+        return findThreadCache(entry);
+    }
+
+    // Find or create the calling thread's cache and remember it in the thread-local table.
+    ThreadCache* findThreadCache(TlsEntry &entry) {
+        if (threadExiting_)
+            return NULL;
+        const std::shared_ptr<std::atomic<bool> > &alive = threadExitNotifier_.alive;
+
+        SAWYER_THREAD_TRAITS::LockGuard lock(cachesMutex_);
+        ThreadCache *cache = NULL;
+        BOOST_FOREACH (ThreadCache *tc, caches_) {
+            if (tc->alive == alive) {
+                cache = tc;
+                break;
+            }
+        }
+        if (!cache) {
+            reclaimThreadCachesNS();
+            cache = new ThreadCache;
+            cache->alive = alive;
+            caches_.push_back(cache);
+        }
+        entry.serialNumber = serialNumber_;
+        entry.cache = cache;
+        return cache;
+    }
+
+    // Give the magazines of exited threads back to the pools.
+    void reclaimThreadCachesNS() {
+        size_t nKept = 0;
+        for (size_t i = 0; i < caches_.size(); ++i) {
+            if (caches_[i]->alive->load(std::memory_order_acquire)) {
+                caches_[nKept++] = caches_[i];
+            } else {
+                for (size_t pn = 0; pn < nPools; ++pn)
+                    pools_[pn].retire(caches_[i]->pools[pn]);
+                delete caches_[i];
+            }
+        }
+        caches_.resize(nKept);
+    }
+#endif
+
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
     //                                  Construction
     ////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////////
@@ -378,6 +645,10 @@ public:
      *  Destroying a pool allocator destroys all its pools, which means that any objects that use storage managed by this pool
      *  will have their storage deleted. */
     virtual ~PoolAllocatorBase() {
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        BOOST_FOREACH (ThreadCache *cache, caches_)
+            delete cache;
+#endif
         delete[] pools_;
     }
 
@@ -422,19 +693,26 @@ public:
     void *allocate(size_t size) {                       // hot
         ASSERT_require(size>0);
         size_t pn = poolNumber(size);
-        return pn < nPools ? pools_[pn].aquire() : ::operator new(size);
+        if (pn >= nPools)
+            return ::operator new(size);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        if (USE_THREAD_CACHES) {
+            if (ThreadCache *cache = threadCache())
+                return pools_[pn].aquire(cache->pools[pn], false);
+        }
+#endif
+        return pools_[pn].aquireShared();
     }
 
     /** Reserve a certain number of objects in the pool.
      *
      *  The pool for the specified object size has its storage increased if necessary so that it is prepared to allocate the
      *  indicated additional number of objects (beyond the number of objects already allocated).  I.e., upon return from this
-     *  call, the free lists will contain in total, at least the specified number of objects. The reserved objects are divided
-     *  equally between all free lists, and since allocations randomly select free lists from which to satisfy requests, one
-     *  should reserve slightly more than what will be needed. Reserving storage is entirely optional. */
+     *  call, the pool will contain in total, at least the specified number of free objects, not counting those that are
+     *  cached by individual threads. Reserving storage is entirely optional. */
     void reserve(size_t objectSize, size_t nObjects) {
         ASSERT_always_require(objectSize > 0); // so objectSize is always used
-        size_t pn = poolNumber(nObjects);
+        size_t pn = poolNumber(objectSize);
         if (pn >= nPools)
             return;
         pools_[pn].reserve(nObjects);
@@ -448,15 +726,40 @@ public:
      *  Thread safety: This method is thread-safe. Of course, for a heavily contested pool the results are probably outdated by
      *  time they're returned to the caller */
     std::pair<size_t, size_t> nAllocated() const {
+        std::vector<PoolStatistics> stats = statistics();
         size_t nAllocated = 0, nReserved = 0;
         for (size_t pn=0; pn<nPools; ++pn) {
-            std::pair<size_t, size_t> pp = pools_[pn].nAllocated();
-            nAllocated += pp.first;
-            nReserved += pp.second;
+            nAllocated += stats[pn].nObjectsInUse();
+            nReserved += stats[pn].nChunks * nCells(pn);
         }
         return std::make_pair(nAllocated, nReserved);
     }
-    
+
+    /** Allocation statistics.
+     *
+     *  Returns one entry per pool, indexed by pool number, summed over all threads that have used this allocator.
+     *
+     *  Thread safety: This method is thread-safe. The counts of other threads are read without stopping those threads, so
+     *  they are approximate for pools that are in use. */
+    std::vector<PoolStatistics> statistics() const {
+        std::vector<PoolStatistics> stats;
+        stats.reserve(nPools);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        SAWYER_THREAD_TRAITS::LockGuard lock(cachesMutex_);
+#endif
+        for (size_t pn=0; pn<nPools; ++pn) {
+            stats.push_back(pools_[pn].statistics());
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+            BOOST_FOREACH (const ThreadCache *cache, caches_) {
+                stats.back().nAllocations += cache->pools[pn].nAllocations.get();
+                stats.back().nDeallocations += cache->pools[pn].nDeallocations.get();
+                stats.back().nMisses += cache->pools[pn].nMisses.get();
+            }
+#endif
+        }
+        return stats;
+    }
+
     /** Deallocate an object of specified size.
      *
      *  The @p addr must be an object address that was previously returned by the @ref allocate method and which hasn't been
@@ -471,7 +774,15 @@ public:
             ASSERT_require(size>0);
             size_t pn = poolNumber(size);
             if (pn < nPools) {
-                pools_[pn].release(addr);
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+                if (USE_THREAD_CACHES) {
+                    if (ThreadCache *cache = threadCache()) {
+                        pools_[pn].release(cache->pools[pn], addr, false);
+                        return;
+                    }
+                }
+#endif
+                pools_[pn].releaseShared(addr);
             } else {
                 ::operator delete(addr);
             }
@@ -481,31 +792,59 @@ public:
     /** Delete unused chunks.
      *
      *  A pool allocator is optimized for the utmost performance when allocating and deallocating small objects, and therefore
-     *  does minimal bookkeeping and does not free chunks.  This method traverses the free lists to discover which chunks have
-     *  no cells in use, removes those cells from the free list, and frees the chunk.
+     *  does minimal bookkeeping and does not free chunks.  This method gives the magazines of exited threads back to their
+     *  pools, traverses the free cells known to the pools to discover which chunks have no cells in use, removes those cells,
+     *  and frees the chunk. Cells cached by running threads count as being in use.
      *
      *  Thread safety: This method is thread-safe. */
     void vacuum() {
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+        {
+            SAWYER_THREAD_TRAITS::LockGuard lock(cachesMutex_);
+            reclaimThreadCachesNS();
+        }
+#endif
         for (size_t pn=0; pn<nPools; ++pn)
             pools_[pn].vacuum();
     }
 
     /** Print pool allocation information.
      *
-     *  Prints some interesting information about each chunk of each pool. The output will be multiple lines.
+     *  Prints the memory use and cache hit rate of each pool. The output will be multiple lines.
      *
      *  Thread safety: This method is thread-safe. */
     void showInfo(std::ostream &out) const {
+        std::vector<PoolStatistics> stats = statistics();
         for (size_t pn=0; pn<nPools; ++pn) {
-            if (!pools_[pn].isEmpty()) {
+            if (stats[pn].nChunks > 0) {
                 out <<"  pool #" <<pn <<"; cellSize = " <<cellSize(pn) <<" bytes:\n";
-                size_t nUsed = pools_[pn].showInfo(out);
-                out <<"    total objects in use: " <<nUsed <<"\n";
+                out <<"    chunks: " <<stats[pn].nChunks <<" (" <<stats[pn].nBytesReserved() <<" bytes)\n";
+                out <<"    total objects in use: " <<stats[pn].nObjectsInUse()
+                    <<" (" <<stats[pn].nBytesInUse() <<" bytes)\n";
+                out <<"    allocations: " <<stats[pn].nAllocations <<", hit rate " <<100.0*stats[pn].hitRate() <<"%\n";
             }
         }
     }
 };
 
+#if SAWYER_POOL_ALLOCATOR_THREAD_CACHES
+template<size_t smallestCell, size_t sizeDelta, size_t nPools, size_t chunkSize, typename Sync>
+thread_local typename PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::TlsEntry
+PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::tlsCaches_[N_TLS_ENTRIES];
+
+template<size_t smallestCell, size_t sizeDelta, size_t nPools, size_t chunkSize, typename Sync>
+thread_local bool
+PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::threadExiting_ = false;
+
+template<size_t smallestCell, size_t sizeDelta, size_t nPools, size_t chunkSize, typename Sync>
+thread_local typename PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::ThreadExitNotifier
+PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::threadExitNotifier_;
+
+template<size_t smallestCell, size_t sizeDelta, size_t nPools, size_t chunkSize, typename Sync>
+std::atomic<boost::uint64_t>
+PoolAllocatorBase<smallestCell, sizeDelta, nPools, chunkSize, Sync>::nextSerialNumber_(0);
+#endif
+
 /** Small object allocation from memory pools.
  *
  *  Thread safety:  This allocator is not thread safe; the caller must synchronize to prevent concurrent calls.
@@ -0,0 +1,56 @@
+#!/bin/bash
+# Outlines all targets of a source file one at a time and then in one batch (-rose:outline:batch), each in its own
+# subdirectory of the current directory, and checks that both write the same files with the same contents. With
+# -rose:outline:new_file each new file of the batch must be written, and none of them may have been left to the project's
+# unparser by a process that failed.
+#
+# Usage: checkOutlineBatch.sh OUTLINE JOBS SOURCE_FILE [SWITCHES...]
+set -e
+
+if [ "$#" -lt 3 ]; then
+    echo "usage: $0 OUTLINE JOBS SOURCE_FILE [SWITCHES...]" >&2
+    exit 1
+fi
+outline="$(cd "$(dirname "$1")" && pwd)/$(basename "$1")"
+jobs="$2"
+source="$(cd "$(dirname "$3")" && pwd)/$(basename "$3")"
+shift 3
+
+rm -rf sequential batch
+mkdir sequential batch
+(cd sequential && "$outline" "$@" -c "$source")
+status=0
+(cd batch && "$outline" -rose:outline:batch -rose:outline:batch_jobs "$jobs" "$@" -c "$source") 2>batch.err || status=$?
+cat batch.err >&2
+if [ "$status" -ne 0 ]; then
+    echo "$0: the batch failed with exit status $status" >&2
+    exit 1
+fi
+if grep -q 'Outliner::outlineBatch()' batch.err; then
+    echo "$0: the batch did not write all of its new files in parallel" >&2
+    exit 1
+fi
+
+# Object files are not compared.
+written() {
+    (cd "$1" && find . -type f ! -name '*.o' | sort)
+}
+if [ "$(written sequential)" != "$(written batch)" ]; then
+    echo "$0: the batch wrote different files than outlining one target at a time" >&2
+    diff <(written sequential) <(written batch) >&2 || true
+    exit 1
+fi
+if [ -z "$(written batch)" ]; then
+    echo "$0: no files were written" >&2
+    exit 1
+fi
+for file in $(written batch); do
+    if [ ! -s "batch/$file" ]; then
+        echo "$0: batch/$file is empty" >&2
+        exit 1
+    fi
+    if ! diff -u "sequential/$file" "batch/$file" >&2; then
+        echo "$0: $file differs from the one written by outlining one target at a time" >&2
+        exit 1
+    fi
+done
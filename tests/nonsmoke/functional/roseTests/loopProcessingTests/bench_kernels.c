@@ -0,0 +1,79 @@
+/* Stencil and matrix kernels for benchmarking the cache model (-model).
+   bench_main.c times this file against its LoopProcessor output. */
+
+#define MM_N 512
+#define TR_N 2048
+#define ST_N 2048
+#define CS_N 2048
+#define VF_N 2097152
+
+double mm_a[MM_N][MM_N], mm_b[MM_N][MM_N], mm_c[MM_N][MM_N];
+double tr_a[TR_N][TR_N], tr_b[TR_N][TR_N];
+double st_a[ST_N][ST_N], st_b[ST_N][ST_N];
+double cs_x[CS_N][CS_N], cs_y[CS_N][CS_N];
+double vf_a[VF_N], vf_b[VF_N], vf_c[VF_N], vf_d[VF_N], vf_e[VF_N];
+
+/* tiling, and interchange to make the k loop outer to j */
+void matmul()
+{
+  int i, j, k;
+  for (i = 0; i <= MM_N-1; i+=1) {
+    for (j = 0; j <= MM_N-1; j+=1) {
+      for (k = 0; k <= MM_N-1; k+=1) {
+        mm_c[i][j] = mm_c[i][j] + mm_a[i][k] * mm_b[k][j];
+      }
+    }
+  }
+}
+
+/* one of the two arrays is always accessed by column: tiling */
+void transpose_add()
+{
+  int i, j;
+  for (i = 0; i <= TR_N-1; i+=1) {
+    for (j = 0; j <= TR_N-1; j+=1) {
+      tr_b[i][j] = tr_b[i][j] + tr_a[j][i];
+    }
+  }
+}
+
+/* a Jacobi sweep followed by the copy back: fusion of the two nests */
+void jacobi2d(int steps)
+{
+  int t, i, j;
+  for (t = 0; t <= steps-1; t+=1) {
+    for (i = 1; i <= ST_N-2; i+=1) {
+      for (j = 1; j <= ST_N-2; j+=1) {
+        st_b[i][j] = 0.2 * (st_a[i][j] + st_a[i-1][j] + st_a[i+1][j] + st_a[i][j-1] + st_a[i][j+1]);
+      }
+    }
+    for (i = 1; i <= ST_N-2; i+=1) {
+      for (j = 1; j <= ST_N-2; j+=1) {
+        st_a[i][j] = st_b[i][j];
+      }
+    }
+  }
+}
+
+/* column-order traversal of row-major arrays: interchange */
+void column_sweep(double s)
+{
+  int i, j;
+  for (j = 0; j <= CS_N-1; j+=1) {
+    for (i = 0; i <= CS_N-1; i+=1) {
+      cs_x[i][j] = cs_x[i][j] + cs_y[i][j] * s;
+    }
+  }
+}
+
+/* two streaming loops sharing vf_a: fusion */
+void vector_fusion()
+{
+  int i;
+  for (i = 0; i <= VF_N-1; i+=1) {
+    vf_a[i] = vf_b[i] + vf_c[i];
+  }
+  for (i = 0; i <= VF_N-1; i+=1) {
+    vf_d[i] = vf_a[i] * vf_e[i];
+  }
+}
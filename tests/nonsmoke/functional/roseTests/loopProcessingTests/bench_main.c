@@ -0,0 +1,129 @@
+/* Times the kernels of bench_kernels.c, or of the LoopProcessor output for it when linked with that instead.
+   Prints one line per kernel: name, best time in seconds over REPEAT runs, and a checksum of its results. */
+#include <stdio.h>
+#include <time.h>
+
+#define MM_N 512
+#define TR_N 2048
+#define ST_N 2048
+#define CS_N 2048
+#define VF_N 2097152
+#define REPEAT 3
+#define JACOBI_STEPS 10
+
+extern double mm_a[MM_N][MM_N], mm_b[MM_N][MM_N], mm_c[MM_N][MM_N];
+extern double tr_a[TR_N][TR_N], tr_b[TR_N][TR_N];
+extern double st_a[ST_N][ST_N], st_b[ST_N][ST_N];
+extern double cs_x[CS_N][CS_N], cs_y[CS_N][CS_N];
+extern double vf_a[VF_N], vf_b[VF_N], vf_c[VF_N], vf_d[VF_N], vf_e[VF_N];
+
+void matmul();
+void transpose_add();
+void jacobi2d(int steps);
+void column_sweep(double s);
+void vector_fusion();
+
+static double now (void)
+{
+  struct timespec t;
+  clock_gettime(CLOCK_MONOTONIC, &t);
+  return t.tv_sec + 1.0e-9 * t.tv_nsec;
+}
+
+static double sum (const double *x, long n)
+{
+  double s = 0.0;
+  long i;
+  for (i = 0; i < n; i++)
+    s += x[i] * (1 + i % 7);
+  return s;
+}
+
+static void fill (double *x, long n, double scale)
+{
+  long i;
+  for (i = 0; i < n; i++)
+    x[i] = scale * ((i * 7919) % 1000) / 1000.0;
+}
+
+static void init_matmul (void)
+{
+  fill(&mm_a[0][0], (long) MM_N * MM_N, 1.0);
+  fill(&mm_b[0][0], (long) MM_N * MM_N, 2.0);
+  fill(&mm_c[0][0], (long) MM_N * MM_N, 0.0);
+}
+
+static void init_transpose_add (void)
+{
+  fill(&tr_a[0][0], (long) TR_N * TR_N, 1.0);
+  fill(&tr_b[0][0], (long) TR_N * TR_N, 3.0);
+}
+
+static void init_jacobi2d (void)
+{
+  fill(&st_a[0][0], (long) ST_N * ST_N, 1.0);
+  fill(&st_b[0][0], (long) ST_N * ST_N, 0.0);
+}
+
+static void init_column_sweep (void)
+{
+  fill(&cs_x[0][0], (long) CS_N * CS_N, 1.0);
+  fill(&cs_y[0][0], (long) CS_N * CS_N, 2.0);
+}
+
+static void init_vector_fusion (void)
+{
+  fill(vf_b, VF_N, 1.0);
+  fill(vf_c, VF_N, 2.0);
+  fill(vf_e, VF_N, 3.0);
+}
+
+int main (void)
+{
+  double best[5] = {1e9, 1e9, 1e9, 1e9, 1e9}, check[5], t;
+  int r;
+  for (r = 0; r < REPEAT; r++)
+  {
+    init_matmul();
+    t = now();
+    matmul();
+    t = now() - t;
+    best[0] = t < best[0] ? t : best[0];
+    check[0] = sum(&mm_c[0][0], (long) MM_N * MM_N);
+
+    init_transpose_add();
+    t = now();
+    transpose_add();
+    t = now() - t;
+    best[1] = t < best[1] ? t : best[1];
+    check[1] = sum(&tr_b[0][0], (long) TR_N * TR_N);
+
+    init_jacobi2d();
+    t = now();
+    jacobi2d(JACOBI_STEPS);
+    t = now() - t;
+    best[2] = t < best[2] ? t : best[2];
+    check[2] = sum(&st_a[0][0], (long) ST_N * ST_N);
+
+    init_column_sweep();
+    t = now();
+    column_sweep(0.5);
+    t = now() - t;
+    best[3] = t < best[3] ? t : best[3];
+    check[3] = sum(&cs_x[0][0], (long) CS_N * CS_N);
+
+    init_vector_fusion();
+    t = now();
+    vector_fusion();
+    t = now() - t;
+    best[4] = t < best[4] ? t : best[4];
+    check[4] = sum(vf_d, VF_N);
+  }
+
+  printf("matmul %.6f %.10e\n", best[0], check[0]);
+  printf("transpose_add %.6f %.10e\n", best[1], check[1]);
+  printf("jacobi2d %.6f %.10e\n", best[2], check[2]);
+  printf("column_sweep %.6f %.10e\n", best[3], check[3]);
+  printf("vector_fusion %.6f %.10e\n", best[4], check[4]);
+  return 0;
+}
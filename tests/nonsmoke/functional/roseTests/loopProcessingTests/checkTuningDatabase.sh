@@ -0,0 +1,57 @@
+#!/bin/bash
+# Tunes the tile size of the loop nest of a source file with -bk_tune, using a harness that doesn't build anything but
+# reports a shorter time when the output is tiled by 32 than when it isn't. Checks that the output is tiled by 32, then
+# that running again takes the tile size from the tuning database and doesn't time any candidate sizes.
+#
+# Usage: checkTuningDatabase.sh WORK_DIRECTORY LOOP_PROCESSOR SOURCE_FILE
+set -e
+
+if [ "$#" -ne 3 ]; then
+    echo "usage: $0 WORK_DIRECTORY LOOP_PROCESSOR SOURCE_FILE" >&2
+    exit 1
+fi
+work="$1"
+loop_processor="$(cd "$(dirname "$2")" && pwd)/$(basename "$2")"
+source="$(cd "$(dirname "$3")" && pwd)/$(basename "$3")"
+name="$(basename "$source")"
+
+rm -rf "$work"
+mkdir -p "$work"
+cd "$work"
+cp "$source" .
+
+# The harness runs once for the untuned output, then once per candidate tile size of each nest not in the database.
+harness="echo >>harness.log; if grep -q '+= 32)' rose_$name; then echo 0.5; else echo 1; fi"
+tune() {
+    rm -f harness.log "rose_$name"
+    "$loop_processor" --edg:no_warnings -w -c -bk_tune 16 -tune_sizes 1,16,32,64 -tune "$harness" "$name" 2>"$1"
+    cat "$1"
+    if ! grep -q '+= 32)' "rose_$name"; then
+        echo "$0: rose_$name is not tiled by 32" >&2
+        exit 1
+    fi
+}
+
+tune tune1.err
+if ! grep -q 'tile size 32' tune1.err; then
+    echo "$0: the first run did not time tile size 32" >&2
+    exit 1
+fi
+if [ "$(wc -l <harness.log)" -lt 5 ]; then
+    echo "$0: the first run ran the harness $(wc -l <harness.log) times; expected at least 5" >&2
+    exit 1
+fi
+if [ ! -s rose_tuning.db ]; then
+    echo "$0: the first run did not write rose_tuning.db" >&2
+    exit 1
+fi
+
+tune tune2.err
+if grep -q 'tile size' tune2.err; then
+    echo "$0: the second run timed tile sizes again instead of using rose_tuning.db" >&2
+    exit 1
+fi
+if [ "$(wc -l <harness.log)" -ne 1 ]; then
+    echo "$0: the second run ran the harness $(wc -l <harness.log) times; expected once" >&2
+    exit 1
+fi
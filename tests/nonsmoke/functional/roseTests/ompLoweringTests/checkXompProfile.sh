@@ -0,0 +1,55 @@
+#!/bin/bash
+# Runs an OpenMP program lowered by ROSE with XOMP region profiling (and hardware counters) turned on, summarizes the
+# profile with xompProfileSummary, and checks that the summary has sane rows for at least the given number of parallel
+# regions of the source file.
+#
+# Usage: checkXompProfile.sh EXECUTABLE SUMMARY_TOOL SOURCE_FILE_NAME MIN_NUMBER_OF_REGIONS
+set -e
+
+if [ "$#" -ne 4 ]; then
+    echo "usage: $0 EXECUTABLE SUMMARY_TOOL SOURCE_FILE_NAME MIN_NUMBER_OF_REGIONS" >&2
+    exit 1
+fi
+exe="$1"
+summary_tool="$2"
+source_name="$3"
+min_regions="$4"
+
+profile="$(basename "$exe").profile"
+rm -f "$profile" "$profile.summary"
+
+XOMP_REGION_PROFILE="$profile" XOMP_REGION_PROFILE_COUNTERS=1 "$exe" >/dev/null
+if [ ! -s "$profile" ]; then
+    echo "$0: $exe did not write $profile" >&2
+    exit 1
+fi
+
+"$summary_tool" "$profile" >"$profile.summary"
+cat "$profile.summary"
+
+# The header has the counter columns because counters were requested, even if the machine doesn't have them.
+if ! head -n 1 "$profile.summary" |grep -q '^region  *count  *total(s)  *mean(s)  *imbal  *barrier  *Mcycles  *miss/Kc$'; then
+    echo "$0: unexpected summary header" >&2
+    exit 1
+fi
+
+# Each region ran at least once, took no time less than its mean, has an imbalance of at least one, and spent between 0
+# and 100 percent of its thread time in barriers.  Some regions (e.g. those in a solver loop) ran more than once.
+awk -v name="$source_name" -v n="$min_regions" '
+    NR > 1 && index($1, name ":") > 0 {
+        nrows++
+        barrier = $6
+        sub(/%$/, "", barrier)
+        barrier += 0
+        if ($2 < 1 || $3 < 0 || $4 > $3 + 1e-6 || $5 < 0.999 || barrier < 0 || barrier > 100.001)
+            nbad++
+        if ($2 > 1)
+            nrepeated++
+    }
+    END {
+        if (nrows < n || nbad > 0 || nrepeated == 0) {
+            printf "expected at least %d regions of %s (some run more than once), found %d (%d invalid, %d repeated)\n", \
+                n, name, nrows, nbad, nrepeated
+            exit 1
+        }
+    }' "$profile.summary"